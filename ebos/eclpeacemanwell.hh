@@ -76,7 +76,7 @@ class EclPeacemanWell : public BaseAuxiliaryModule<TypeTag>
 {
     typedef BaseAuxiliaryModule<TypeTag> AuxModule;
 
-    typedef typename AuxModule::NeighborSet NeighborSet;
+    typedef typename AuxModule::NeighborPair NeighborPair;
     typedef typename GET_PROP_TYPE(TypeTag, JacobianMatrix) JacobianMatrix;
     typedef typename GET_PROP_TYPE(TypeTag, SolutionVector) SolutionVector;
     typedef typename GET_PROP_TYPE(TypeTag, GlobalEqVector) GlobalEqVector;
@@ -297,20 +297,21 @@ public:
     /*!
      * \copydoc Ewoms::BaseAuxiliaryModule::addNeighbors()
      */
-    virtual void addNeighbors(std::vector<NeighborSet>& neighbors) const
+    virtual void addNeighbors(std::vector<NeighborPair>& neighbors) const
     {
-        int wellGlobalDof = AuxModule::localToGlobalDof(/*localDofIdx=*/0);
+        unsigned wellGlobalDof = static_cast<unsigned>(AuxModule::localToGlobalDof(/*localDofIdx=*/0));
 
         // the well's bottom hole pressure always affects itself...
-        neighbors[wellGlobalDof].insert(wellGlobalDof);
+        neighbors.emplace_back(wellGlobalDof, wellGlobalDof);
 
         // add the grid DOFs which are influenced by the well, and add the well dof to
         // the ones neighboring the grid ones
         auto wellDofIt = dofVariables_.begin();
         const auto& wellDofEndIt = dofVariables_.end();
         for (; wellDofIt != wellDofEndIt; ++ wellDofIt) {
-            neighbors[wellGlobalDof].insert(wellDofIt->first);
-            neighbors[wellDofIt->first].insert(wellGlobalDof);
+            unsigned gridDof = static_cast<unsigned>(wellDofIt->first);
+            neighbors.emplace_back(wellGlobalDof, gridDof);
+            neighbors.emplace_back(gridDof, wellGlobalDof);
         }
     }
 
@@ -466,6 +467,20 @@ public:
     }
 
 
+    /*!
+     * \copydoc Ewoms::BaseAuxiliaryModule::linearizeResidual()
+     */
+    virtual void linearizeResidual(GlobalEqVector& residual)
+    {
+        unsigned wellGlobalDofIdx = AuxModule::localToGlobalDof(/*localDofIdx=*/0);
+        residual[wellGlobalDofIdx] = 0.0;
+
+        if (wellStatus() == Shut)
+            return;
+
+        residual[wellGlobalDofIdx][0] = wellResidual_(actualBottomHolePressure_);
+    }
+
     // reset the well to the initial state, i.e. remove all degrees of freedom...
     void clear()
     {
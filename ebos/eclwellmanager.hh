@@ -43,7 +43,7 @@
 #include <opm/common/Exceptions.hpp>
 
 #include <ewoms/common/propertysystem.hh>
-#include <ewoms/parallel/threadedentityiterator.hh>
+#include <ewoms/parallel/threadedentityscheduler.hh>
 
 #include <dune/grid/common/gridenums.hh>
 
@@ -403,24 +403,22 @@ public:
             wells_[wellIdx]->beginIterationPreProcess();
 
         // call the accumulation routines
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator_.gridManager().gridView());
+        ThreadedEntityScheduler<GridView, /*codim=*/0> elemScheduler(simulator_.gridManager().gridView());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
             ElementContext elemCtx(simulator_);
-            auto elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
+            elemScheduler.run([&](const Element& elem) {
                 if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+                    return;
 
                 elemCtx.updatePrimaryStencil(elem);
                 elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
 
                 for (size_t wellIdx = 0; wellIdx < wellSize; ++wellIdx)
                     wells_[wellIdx]->beginIterationAccumulate(elemCtx, /*timeIdx=*/0);
-            }
+            });
         }
 
         // call the postprocessing routines
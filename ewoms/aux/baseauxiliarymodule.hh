@@ -30,8 +30,10 @@
 #include <ewoms/common/propertysystem.hh>
 
 #include <ewoms/disc/common/fvbaseproperties.hh>
+#include <ewoms/linear/sparsitypattern.hh>
 
-#include <set>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace Ewoms {
@@ -64,7 +66,8 @@ class BaseAuxiliaryModule
     typedef typename GET_PROP_TYPE(TypeTag, JacobianMatrix) JacobianMatrix;
 
 protected:
-    typedef std::set<unsigned> NeighborSet;
+    //! A pair of global indices (row, column) which are connected in the Jacobian matrix
+    typedef std::pair<unsigned, unsigned> NeighborPair;
 
 public:
     virtual ~BaseAuxiliaryModule()
@@ -104,8 +107,11 @@ public:
     /*!
      * \brief Specify the additional neighboring correlations caused by the auxiliary
      *        module.
+     *
+     * Each (row, column) pair appended to the vector causes the corresponding block to
+     * be allocated in the Jacobian matrix. Duplicate pairs are allowed.
      */
-    virtual void addNeighbors(std::vector<NeighborSet>& neighbors) const = 0;
+    virtual void addNeighbors(std::vector<NeighborPair>& neighbors) const = 0;
 
     /*!
      * \brief Set the initial condition of the auxiliary module in the solution vector.
@@ -117,8 +123,51 @@ public:
      */
     virtual void linearize(JacobianMatrix& matrix, GlobalEqVector& residual) = 0;
 
+    /*!
+     * \brief Evaluate the residual of the auxiliary equation without linearizing it.
+     *
+     * Only the entries of the residual vector which are written by linearize() may be
+     * modified. By default, the auxiliary equation is linearized into a scratch matrix
+     * which only contains the blocks specified by addNeighbors() and the diagonal blocks
+     * of their rows and columns. Modules which can evaluate their residual more cheaply
+     * should overload this method.
+     */
+    virtual void linearizeResidual(GlobalEqVector& residual)
+    {
+        if (!scratchMatrix_ || scratchMatrix_->N() != residual.size())
+            createScratchMatrix_(residual.size());
+
+        (*scratchMatrix_) = 0.0;
+        linearize(*scratchMatrix_, residual);
+    }
+
 private:
+    void createScratchMatrix_(size_t numRows)
+    {
+        std::vector<NeighborPair> neighbors;
+        addNeighbors(neighbors);
+
+        Linear::SparsityPattern pattern;
+        pattern.reset(numRows);
+        for (const auto& neighbor : neighbors) {
+            pattern.countEntries(neighbor.first, /*numEntries=*/2);
+            pattern.countEntries(neighbor.second, /*numEntries=*/1);
+        }
+
+        pattern.beginFill();
+        for (const auto& neighbor : neighbors) {
+            pattern.addEntry(neighbor.first, neighbor.second);
+            pattern.addEntry(neighbor.first, neighbor.first);
+            pattern.addEntry(neighbor.second, neighbor.second);
+        }
+        pattern.finalize();
+
+        scratchMatrix_.reset(new JacobianMatrix(numRows, numRows, JacobianMatrix::random));
+        pattern.setupMatrix(*scratchMatrix_);
+    }
+
     int dofOffset_;
+    std::unique_ptr<JacobianMatrix> scratchMatrix_;
 };
 
 } // namespace Ewoms
@@ -43,6 +43,11 @@ namespace Ewoms {
  * performance. On the flipside data cannot be written to on an individual basis and it
  * requires significantly more memory than a plain array. PffVector stands for "PreFetch
  * Friendly Grid Vector".
+ *
+ * The data of the degrees of freedom of an element's stencil is stored contiguously and
+ * in the order in which the elements are traversed by the grid view. Calling prefetch()
+ * for the next element while working on the current one thus hides the memory latency
+ * of accessing the data.
  */
 template <class GridView, class Stencil, class Data, class DofMapper>
 class PffGridVector
@@ -60,10 +65,14 @@ public:
     template <class DistFn>
     void update(const DistFn& distFn)
     {
+        // the grid might have been changed since the object was created
+        elementMapper_.update();
+
         unsigned numElements = gridView_.size(/*codim=*/0);
         unsigned numLocalDofs = computeNumLocalDofs_();
 
         elemData_.resize(numElements);
+        elemNumDof_.resize(numElements);
         data_.resize(numLocalDofs);
 
         // update the pointers for the element data: for this, we need to loop over the
@@ -84,6 +93,7 @@ public:
 
             stencil.update(elem);
             unsigned numDof = stencil.numDof();
+            elemNumDof_[elemIdx] = numDof;
             for (unsigned localDofIdx = 0; localDofIdx < numDof; ++ localDofIdx)
                 distFn(curElemDataPtr[localDofIdx], stencil, localDofIdx);
 
@@ -93,29 +103,39 @@ public:
         }
     }
 
-    void prefetch(const Element& elem) const
+    /*!
+     * \brief Returns the index of an element which is used by the container.
+     */
+    unsigned elementIndex(const Element& elem) const
     {
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
-        unsigned elemIdx = elementMapper_.index(elem);
+        return static_cast<unsigned>(elementMapper_.index(elem));
 #else
-        unsigned elemIdx = elementMapper_.map(elem);
+        return static_cast<unsigned>(elementMapper_.map(elem));
 #endif
+    }
+
+    /*!
+     * \brief Returns the number of degrees of freedom in the stencil of an element.
+     */
+    unsigned numDof(unsigned elemIdx) const
+    { return elemNumDof_[elemIdx]; }
+
+    void prefetch(const Element& elem) const
+    { prefetch(elementIndex(elem)); }
 
+    void prefetch(unsigned elemIdx) const
+    {
         // we use 0 as the temporal locality, because it is reasonable to assume that an
         // entry will only be accessed once.
-        Ewoms::prefetch</*temporalLocality=*/0>(elemData_[elemIdx]);
+        Ewoms::prefetch</*temporalLocality=*/0>(*elemData_[elemIdx], elemNumDof_[elemIdx]);
     }
 
     const Data& get(const Element& elem, unsigned localDofIdx) const
-    {
-#if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
-        unsigned elemIdx = elementMapper_.index(elem);
-#else
-        unsigned elemIdx = elementMapper_.map(elem);
-#endif
+    { return get(elementIndex(elem), localDofIdx); }
 
-        return elemData_[elemIdx][localDofIdx];
-    }
+    const Data& get(unsigned elemIdx, unsigned localDofIdx) const
+    { return elemData_[elemIdx][localDofIdx]; }
 
 private:
     unsigned computeNumLocalDofs_() const
@@ -139,6 +159,7 @@ private:
     const DofMapper& dofMapper_;
     std::vector<Data> data_;
     std::vector<Data*> elemData_;
+    std::vector<unsigned> elemNumDof_;
 };
 
 } // namespace Ewoms
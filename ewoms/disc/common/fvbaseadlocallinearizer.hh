@@ -40,6 +40,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+
 namespace Ewoms {
 // forward declaration
 template<class TypeTag>
@@ -142,6 +144,9 @@ public:
         simulatorPtr_ = &simulator;
         delete internalElemContext_;
         internalElemContext_ = new ElementContext(simulator);
+
+        // allocate the memory for the largest stencil of the grid up front
+        residual_.reserve(simulator.model().maxNumStencilDof());
     }
 
     /*!
@@ -256,16 +261,27 @@ protected:
         size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
 
         residual_.resize(numDof);
-        jacobian_.setSize(numDof, numPrimaryDof);
+
+        // resizing a Dune::Matrix always reallocates its memory. the local Jacobian is
+        // thus only enlarged if needed and the blocks outside of the current stencil
+        // are ignored.
+        if (jacobian_.N() < numDof || jacobian_.M() < numPrimaryDof)
+            jacobian_.setSize(std::max<size_t>(jacobian_.N(), numDof),
+                              std::max<size_t>(jacobian_.M(), numPrimaryDof));
     }
 
     /*!
      * \brief Reset the all relevant internal attributes to 0
      */
-    void reset_(const ElementContext& elemCtx OPM_UNUSED)
+    void reset_(const ElementContext& elemCtx)
     {
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx)
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++ dofIdx)
+                jacobian_[dofIdx][primaryDofIdx] = 0.0;
+
         residual_ = 0.0;
-        jacobian_ = 0.0;
     }
 
     /*!
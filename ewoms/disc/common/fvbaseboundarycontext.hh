@@ -31,9 +31,13 @@
 #include "fvbaseproperties.hh"
 
 #include <opm/common/Unused.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
 
 #include <dune/common/fvector.hh>
 
+#include <stdexcept>
+
 namespace Ewoms {
 
 /*!
@@ -146,13 +150,32 @@ public:
      * \param boundaryFaceIdx The local index of the boundary segment
      * \param timeIdx The index of the solution used by the time discretization
      */
-    Vector normal(unsigned boundaryFaceIdx, unsigned timeIdx) const
+    Vector normal(unsigned boundaryFaceIdx, unsigned timeIdx OPM_UNUSED) const
     {
-        auto tmp = stencil(timeIdx).boundaryFace[boundaryFaceIdx].normal;
-        tmp /= tmp.two_norm();
+        const auto& boundaryFaceTable = model().boundaryFaceTable();
+        unsigned elemIdx = boundaryFaceTable.elementIndex(element());
+        const auto* face = boundaryFaceTable.stencilFace(elemIdx, boundaryFaceIdx);
+        if (!face)
+            OPM_THROW(std::logic_error,
+                      "Boundary face " << boundaryFaceIdx << " is not located on the "
+                      "boundary of the domain");
+
+        Vector tmp;
+        for (unsigned i = 0; i < dimWorld; ++i)
+            tmp[i] = face->normal[i];
         return tmp;
     }
 
+    /*!
+     * \brief Returns the index of the grid's boundary segment which contains a given
+     *        boundary face.
+     *
+     * \param boundaryFaceIdx The local index of the boundary segment
+     * \param timeIdx The index of the solution used by the time discretization
+     */
+    unsigned boundaryId(unsigned boundaryFaceIdx, unsigned timeIdx) const
+    { return stencil(timeIdx).boundaryFace(boundaryFaceIdx).boundarySegmentIndex(); }
+
     /*!
      * \brief Returns the area [m^2] of a given boudary segment.
      */
@@ -0,0 +1,293 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::FvBaseBoundaryFaceTable
+ */
+#ifndef EWOMS_FV_BASE_BOUNDARY_FACE_TABLE_HH
+#define EWOMS_FV_BASE_BOUNDARY_FACE_TABLE_HH
+
+#include "fvbaseproperties.hh"
+
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/version.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Ewoms {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief The precomputed boundary faces of all elements of a grid view.
+ *
+ * For each face of a stencil which is located on the boundary of the domain, the index
+ * of the element, the local index of the face in the element's stencil, the global
+ * index of the degree of freedom in its interior, its area, its outer unit normal, its
+ * integration point and the index of the grid's boundary segment which contains it are
+ * stored. The faces are stored in a flat array which is sorted by the element index.
+ * This allows to find out in constant time whether an element touches the boundary and
+ * it allows to run passes which only visit the boundary of the domain.
+ *
+ * The object must be updated whenever the grid is changed.
+ */
+template <class TypeTag>
+class FvBaseBoundaryFaceTable
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+    typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
+    typedef typename GET_PROP_TYPE(TypeTag, Stencil) Stencil;
+    typedef typename GET_PROP_TYPE(TypeTag, DofMapper) DofMapper;
+
+    typedef typename GridView::template Codim<0>::Entity Element;
+    typedef Dune::MultipleCodimMultipleGeomTypeMapper<GridView, Dune::MCMGElementLayout> ElementMapper;
+
+    enum { dimWorld = GridView::dimensionworld };
+
+    typedef typename GridView::ctype CoordScalar;
+    typedef Dune::FieldVector<CoordScalar, dimWorld> GlobalPosition;
+
+    struct Segment_
+    {
+        unsigned segmentIdx;
+        unsigned numFaces;
+        GlobalPosition normal;
+        GlobalPosition center;
+    };
+
+public:
+    /*!
+     * \brief The data of a single boundary face.
+     */
+    struct Face
+    {
+        //! the index of the element to which the face belongs
+        unsigned elementIdx;
+        //! the index of the face in the stencil of the element
+        unsigned short localFaceIdx;
+        //! the local index of the degree of freedom in the interior of the face
+        unsigned short interiorIdx;
+        //! the global index of the degree of freedom in the interior of the face
+        unsigned globalDofIdx;
+        //! the index of the grid's boundary segment which contains the face
+        unsigned boundaryId;
+        //! the area of the face [m^2]
+        Scalar area;
+        //! the outer unit normal of the face
+        GlobalPosition normal;
+        //! the global position of the integration point of the face
+        GlobalPosition integrationPos;
+    };
+
+    explicit FvBaseBoundaryFaceTable(const GridView& gridView)
+        : gridView_(gridView)
+        , elementMapper_(gridView_)
+        , gridSequenceNumber_(-1)
+    { }
+
+    /*!
+     * \brief Determine the boundary faces of all elements of the grid view.
+     *
+     * \param dofMapper The mapper for the degrees of freedom of the discretization
+     * \param gridSequenceNumber The sequence number of the grid, i.e., a number which
+     *                           is changed whenever the grid is modified
+     */
+    void update(const DofMapper& dofMapper, int gridSequenceNumber)
+    {
+        // the grid might have been changed since the object was created
+        elementMapper_.update();
+        gridSequenceNumber_ = gridSequenceNumber;
+
+        size_t numElements = static_cast<size_t>(gridView_.size(/*codim=*/0));
+        std::vector<Face> unsortedFaces;
+        std::vector<Segment_> segments;
+        std::vector<int> faceSegment;
+
+        Stencil stencil(gridView_, dofMapper);
+        auto elemIt = gridView_.template begin</*codim=*/0>();
+        const auto& elemEndIt = gridView_.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            if (!elem.hasBoundaryIntersections())
+                continue;
+
+            // the boundary segments of the element. the faces of the stencil are
+            // matched to the intersections using the segment index
+            segments.clear();
+            auto isIt = gridView_.ibegin(elem);
+            const auto& isEndIt = gridView_.iend(elem);
+            for (; isIt != isEndIt; ++isIt) {
+                const auto& intersection = *isIt;
+                if (!intersection.boundary())
+                    continue;
+
+                Segment_ segment;
+                segment.segmentIdx = static_cast<unsigned>(intersection.boundarySegmentIndex());
+                segment.numFaces = 0;
+                segment.normal = intersection.centerUnitOuterNormal();
+                segment.center = intersection.geometry().center();
+                segments.push_back(segment);
+            }
+
+            stencil.update(elem);
+            size_t numStencilFaces = stencil.numBoundaryFaces();
+            faceSegment.assign(numStencilFaces, -1);
+            for (unsigned bfIdx = 0; bfIdx < numStencilFaces; ++bfIdx) {
+                // faces on process boundaries are not part of the domain boundary and
+                // thus do not match any segment
+                unsigned segIdx = stencil.boundaryFace(bfIdx).boundarySegmentIndex();
+                for (unsigned i = 0; i < segments.size(); ++i) {
+                    if (segments[i].segmentIdx == segIdx) {
+                        faceSegment[bfIdx] = static_cast<int>(i);
+                        ++ segments[i].numFaces;
+                        break;
+                    }
+                }
+            }
+
+            for (unsigned bfIdx = 0; bfIdx < numStencilFaces; ++bfIdx) {
+                if (faceSegment[bfIdx] < 0)
+                    continue;
+
+                const auto& bf = stencil.boundaryFace(bfIdx);
+                const auto& segment = segments[static_cast<unsigned>(faceSegment[bfIdx])];
+
+                Face face;
+                face.elementIdx = elementIndex(elem);
+                face.localFaceIdx = static_cast<unsigned short>(bfIdx);
+                face.interiorIdx = bf.interiorIndex();
+                face.globalDofIdx = stencil.globalSpaceIndex(bf.interiorIndex());
+                face.boundaryId = segment.segmentIdx;
+                face.area = bf.area();
+                face.normal = segment.normal;
+                // if a segment corresponds to a single face, its integration point is
+                // the center of the segment. (some stencils do not store the integration
+                // points of their faces.)
+                if (segment.numFaces == 1)
+                    face.integrationPos = segment.center;
+                else
+                    face.integrationPos = bf.integrationPos();
+                unsortedFaces.push_back(face);
+            }
+        }
+
+        // sort the faces by element index. (the order in which the elements are
+        // traversed is not necessarily the one of their indices.)
+        faceOffsets_.assign(numElements + 1, 0);
+        for (const auto& face : unsortedFaces)
+            ++ faceOffsets_[face.elementIdx + 1];
+        for (size_t elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            faceOffsets_[elemIdx + 1] += faceOffsets_[elemIdx];
+
+        faces_.resize(unsortedFaces.size());
+        std::vector<size_t> nextPos(faceOffsets_.begin(), faceOffsets_.end() - 1);
+        for (const auto& face : unsortedFaces)
+            faces_[nextPos[face.elementIdx]++] = face;
+    }
+
+    /*!
+     * \brief Returns true iff the table is consistent with the current grid.
+     *
+     * \param gridSequenceNumber The current sequence number of the grid
+     */
+    bool isUpToDate(int gridSequenceNumber) const
+    { return gridSequenceNumber_ == gridSequenceNumber; }
+
+    /*!
+     * \brief Returns the index of an element which is used by the table.
+     */
+    unsigned elementIndex(const Element& elem) const
+    {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
+        return static_cast<unsigned>(elementMapper_.index(elem));
+#else
+        return static_cast<unsigned>(elementMapper_.map(elem));
+#endif
+    }
+
+    /*!
+     * \brief Returns the number of boundary faces of an element.
+     */
+    size_t numBoundaryFaces(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx + 1] - faceOffsets_[elemIdx]; }
+
+    /*!
+     * \brief Returns a boundary face of an element.
+     *
+     * \param elemIdx The index of the element
+     * \param faceIdx The index of the face within the boundary faces of the element
+     *                (this is not necessarily the index of the face in the stencil)
+     */
+    const Face& face(unsigned elemIdx, unsigned faceIdx) const
+    {
+        assert(faceIdx < numBoundaryFaces(elemIdx));
+        return faces_[faceOffsets_[elemIdx] + faceIdx];
+    }
+
+    /*!
+     * \brief Returns the boundary face of an element given its index in the element's
+     *        stencil.
+     *
+     * If the face is not located on the boundary of the domain, a null pointer is
+     * returned.
+     */
+    const Face* stencilFace(unsigned elemIdx, unsigned localFaceIdx) const
+    {
+        for (size_t i = faceOffsets_[elemIdx]; i < faceOffsets_[elemIdx + 1]; ++i)
+            if (faces_[i].localFaceIdx == localFaceIdx)
+                return &faces_[i];
+        return 0;
+    }
+
+    /*!
+     * \brief Returns the boundary faces of all elements.
+     */
+    const std::vector<Face>& faces() const
+    { return faces_; }
+
+    /*!
+     * \brief Returns the number of bytes allocated by the table.
+     */
+    size_t memoryUsage() const
+    {
+        return
+            faceOffsets_.capacity()*sizeof(size_t)
+            + faces_.capacity()*sizeof(Face);
+    }
+
+private:
+    GridView gridView_;
+    ElementMapper elementMapper_;
+    int gridSequenceNumber_;
+
+    std::vector<size_t> faceOffsets_;
+    std::vector<Face> faces_;
+};
+
+} // namespace Ewoms
+
+#endif
@@ -0,0 +1,153 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::FvBaseConstraintsMap
+ */
+#ifndef EWOMS_FV_BASE_CONSTRAINTS_MAP_HH
+#define EWOMS_FV_BASE_CONSTRAINTS_MAP_HH
+
+#include "fvbaseproperties.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Ewoms {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Stores the constraints of all constraint degrees of freedom.
+ *
+ * The constraints are kept in a vector which is sorted by the global index of the
+ * degrees of freedom. In addition, a flag is stored for each degree of freedom of the
+ * grid, so that finding out whether a degree of freedom is constraint does not require
+ * a search. The interface is a subset of the one of std::map<unsigned, Constraints>.
+ */
+template <class TypeTag>
+class FvBaseConstraintsMap
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Constraints) Constraints;
+
+public:
+    typedef std::pair<unsigned, Constraints> value_type;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    /*!
+     * \brief Remove all constraints and set the number of degrees of freedom.
+     */
+    void clear(size_t numDof)
+    {
+        entries_.clear();
+        isConstraint_.assign(numDof, false);
+    }
+
+    /*!
+     * \brief Add the constraints for a list of degrees of freedom.
+     *
+     * The list is sorted by this method. If it contains a degree of freedom more than
+     * once, or if the degree of freedom is already constraint, the entry which comes
+     * first after sorting is used.
+     */
+    void insert(std::vector<value_type>& newEntries)
+    {
+        std::stable_sort(newEntries.begin(), newEntries.end(),
+                         [](const value_type& a, const value_type& b)
+                         { return a.first < b.first; });
+
+        size_t numOldEntries = entries_.size();
+        for (const auto& entry : newEntries) {
+            if (isConstraint_[entry.first])
+                continue;
+
+            isConstraint_[entry.first] = true;
+            entries_.push_back(entry);
+        }
+
+        if (numOldEntries > 0)
+            std::inplace_merge(entries_.begin(),
+                               entries_.begin() + static_cast<long>(numOldEntries),
+                               entries_.end(),
+                               [](const value_type& a, const value_type& b)
+                               { return a.first < b.first; });
+    }
+
+    /*!
+     * \brief Returns 1 if a degree of freedom is constraint and 0 if not.
+     */
+    size_t count(unsigned dofIdx) const
+    { return (dofIdx < isConstraint_.size() && isConstraint_[dofIdx]) ? 1 : 0; }
+
+    /*!
+     * \brief Returns the constraints of a constraint degree of freedom.
+     *
+     * An exception is thrown if the degree of freedom is not constraint.
+     */
+    const Constraints& at(unsigned dofIdx) const
+    {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), dofIdx,
+                                   [](const value_type& entry, unsigned idx)
+                                   { return entry.first < idx; });
+        if (it == entries_.end() || it->first != dofIdx)
+            throw std::out_of_range("Degree of freedom is not constraint");
+        return it->second;
+    }
+
+    /*!
+     * \brief Returns the number of constraint degrees of freedom.
+     */
+    size_t size() const
+    { return entries_.size(); }
+
+    /*!
+     * \brief Returns true iff no degree of freedom is constraint.
+     */
+    bool empty() const
+    { return entries_.empty(); }
+
+    /*!
+     * \brief Returns an iterator to the first constraint degree of freedom.
+     *
+     * The constraint degrees of freedom are visited by ascending index.
+     */
+    const_iterator begin() const
+    { return entries_.begin(); }
+
+    /*!
+     * \brief Returns an iterator past the last constraint degree of freedom.
+     */
+    const_iterator end() const
+    { return entries_.end(); }
+
+private:
+    std::vector<value_type> entries_;
+    std::vector<bool> isConstraint_;
+};
+
+} // namespace Ewoms
+
+#endif
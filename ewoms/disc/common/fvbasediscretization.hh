@@ -37,6 +37,7 @@
 #include "fvbaselocalresidual.hh"
 #include "fvbaseelementcontext.hh"
 #include "fvbaseboundarycontext.hh"
+#include "fvbaseboundaryfacetable.hh"
 #include "fvbaseconstraintscontext.hh"
 #include "fvbaseconstraints.hh"
 #include "fvbasediscretization.hh"
@@ -45,13 +46,17 @@
 #include "fvbaseprimaryvariables.hh"
 #include "fvbaseintensivequantities.hh"
 #include "fvbaseextensivequantities.hh"
+#include "fvbaseintensivequantitiesfieldstorage.hh"
 
 #include <ewoms/parallel/gridcommhandles.hh>
 #include <ewoms/parallel/threadmanager.hh>
+#include <ewoms/parallel/threadedentityscheduler.hh>
 #include <ewoms/linear/nullborderlistmanager.hh>
 #include <ewoms/common/simulator.hh>
 #include <ewoms/aux/baseauxiliarymodule.hh>
 #include <ewoms/common/alignedallocator.hh>
+#include <ewoms/common/pffgridvector.hh>
+#include <ewoms/common/prefetch.hh>
 #include <ewoms/common/timer.hh>
 #include <ewoms/common/timerguard.hh>
 
@@ -61,6 +66,7 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
+#include <dune/common/version.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bvector.hh>
@@ -72,6 +78,9 @@
 #include <dune/fem/misc/capabilities.hh>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 #include <limits>
 #include <list>
 #include <sstream>
@@ -110,6 +119,9 @@ SET_TYPE_PROP(FvBaseDiscretization, DiscLocalResidual, Ewoms::FvBaseLocalResidua
 SET_TYPE_PROP(FvBaseDiscretization, DiscIntensiveQuantities, Ewoms::FvBaseIntensiveQuantities<TypeTag>);
 SET_TYPE_PROP(FvBaseDiscretization, DiscExtensiveQuantities, Ewoms::FvBaseExtensiveQuantities<TypeTag>);
 
+//! By default, the intensive quantities cannot be stored field by field
+SET_TYPE_PROP(FvBaseDiscretization, IntensiveQuantitiesFieldStorage, Ewoms::FvBaseIntensiveQuantitiesFieldStorage<TypeTag>);
+
 //! Calculates the gradient of any quantity given the index of a flux approximation point
 SET_TYPE_PROP(FvBaseDiscretization, GradientCalculator, Ewoms::FvBaseGradientCalculator<TypeTag>);
 
@@ -198,6 +210,12 @@ SET_TYPE_PROP(FvBaseDiscretization, ThreadManager, Ewoms::ThreadManager<TypeTag>
 SET_INT_PROP(FvBaseDiscretization, ThreadsPerProcess, 1);
 SET_BOOL_PROP(FvBaseDiscretization, UseLinearizationLock, true);
 
+//! do not color the elements for linearization by default
+SET_BOOL_PROP(FvBaseDiscretization, EnableColoredLinearization, false);
+
+//! search for the matrix blocks during linearization by default
+SET_BOOL_PROP(FvBaseDiscretization, EnableJacobianScatterMap, false);
+
 /*!
  * \brief Linearizer for the global system of equations.
  */
@@ -238,6 +256,19 @@ SET_BOOL_PROP(FvBaseDiscretization, EnableIntensiveQuantityCache, false);
 // enable the intensive quantity cache above to avoid getting an exception...
 SET_BOOL_PROP(FvBaseDiscretization, EnableThermodynamicHints, false);
 
+// by default, the intensive quantities are evaluated lazily while linearizing the
+// elements
+SET_BOOL_PROP(FvBaseDiscretization, PrefillIntensiveQuantityCache, false);
+
+// by default, the intensive quantity cache is an array of IntensiveQuantities objects
+SET_BOOL_PROP(FvBaseDiscretization, EnableIntensiveQuantityFieldStorage, false);
+SET_BOOL_PROP(FvBaseDiscretization, IntensiveQuantityFieldStorageSinglePrecision, false);
+SET_BOOL_PROP(FvBaseDiscretization, PrintIntensiveQuantityCacheMemoryUsage, false);
+
+// by default, the solution of the last time step is used as the initial guess of the
+// Newton method
+SET_INT_PROP(FvBaseDiscretization, PredictorOrder, 0);
+
 // if the deflection of the newton method is large, we do not need to solve the linear
 // approximation accurately. Assuming that the value for the current solution is quite
 // close to the final value, a reduction of 3 orders of magnitude in the defect should be
@@ -272,6 +303,7 @@ class FvBaseDiscretization
     typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
     typedef typename GET_PROP_TYPE(TypeTag, Evaluation) Evaluation;
     typedef typename GET_PROP_TYPE(TypeTag, ElementMapper) ElementMapper;
+    typedef Ewoms::FvBaseBoundaryFaceTable<TypeTag> BoundaryFaceTable;
     typedef typename GET_PROP_TYPE(TypeTag, VertexMapper) VertexMapper;
     typedef typename GET_PROP_TYPE(TypeTag, DofMapper) DofMapper;
     typedef typename GET_PROP_TYPE(TypeTag, SolutionVector) SolutionVector;
@@ -284,6 +316,7 @@ class FvBaseDiscretization
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
     typedef typename GET_PROP_TYPE(TypeTag, BoundaryContext) BoundaryContext;
     typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantitiesFieldStorage) IntensiveQuantitiesFieldStorage;
     typedef typename GET_PROP_TYPE(TypeTag, ExtensiveQuantities) ExtensiveQuantities;
     typedef typename GET_PROP_TYPE(TypeTag, GradientCalculator) GradientCalculator;
     typedef typename GET_PROP_TYPE(TypeTag, Stencil) Stencil;
@@ -304,6 +337,8 @@ class FvBaseDiscretization
 
     typedef typename GridView::template Codim<0>::Entity Element;
     typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+    typedef typename Element::EntitySeed ElementSeed;
+    typedef Ewoms::ThreadedEntityScheduler<GridView, /*codim=*/0> ElementScheduler;
 
     typedef Opm::MathToolbox<Evaluation> Toolbox;
     typedef Dune::FieldVector<Evaluation, numEq> VectorBlock;
@@ -361,6 +396,7 @@ public:
         , newtonMethod_(simulator)
         , localLinearizer_(ThreadManager::maxThreads())
         , linearizer_(new Linearizer())
+        , boundaryFaceTable_(gridView_)
 #if HAVE_DUNE_FEM
         , space_( simulator.gridManager().gridPart() )
 #else
@@ -384,14 +420,43 @@ public:
                       "volume discretization (is: " << Dune::className<Discretization>() << ")");
 
         enableStorageCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache);
+        if (enableStorageCache_ && GET_PROP_VALUE(TypeTag, ExtensiveStorageTerm))
+            OPM_THROW(Opm::NotImplemented,
+                      "The storage term cannot be cached if it depends on the extensive "
+                      "quantities");
+        storageCacheUpToDate_ = false;
+        prefillIntensiveQuantityCache_ = EWOMS_GET_PARAM(TypeTag, bool, PrefillIntensiveQuantityCache);
+        // the cached intensive quantities only correspond exactly to the solution if the
+        // Newton method recalculates them after each update
+        intensiveQuantityCacheExact_ =
+            EWOMS_GET_PARAM(TypeTag, Scalar, NewtonIntensiveQuantitiesTolerance) <= 0.0;
+        useIntensiveQuantityFieldStorage_ =
+            storeIntensiveQuantities()
+            && EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityFieldStorage);
+        if (useIntensiveQuantityFieldStorage_ && !IntensiveQuantitiesFieldStorage::isSupported())
+            OPM_THROW(Opm::NotImplemented,
+                      "Storing the intensive quantities field by field is not supported by "
+                      "the model (intensive quantities: "
+                      << Dune::className<IntensiveQuantities>() << ")");
+        predictorOrder_ = EWOMS_GET_PARAM(TypeTag, unsigned, PredictorOrder);
+        if (predictorOrder_ > 2)
+            OPM_THROW(std::runtime_error,
+                      "Only linear and quadratic extrapolation of the initial guess are "
+                      "supported (PredictorOrder is " << predictorOrder_ << ")");
+        numPredictorLevels_ = 0;
+        predictorDt_[0] = predictorDt_[1] = 0.0;
+        maxNumStencilDof_ = 0;
+        maxNumStencilInteriorFaces_ = 0;
+        intQuantsWorkListGridSequenceNumber_ = -1;
 
         size_t numDof = asImp_().numGridDof();
         for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
             solution_[timeIdx].reset(new DiscreteFunction("solution", space_));
+            intensiveQuantityCacheRefSlot_[timeIdx] = timeIdx;
 
             if (storeIntensiveQuantities()) {
-                intensiveQuantityCache_[timeIdx].resize(numDof);
-                intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof, /*value=*/false);
+                resizeIntensiveQuantityCacheSlot_(timeIdx, numDof);
+                intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof, /*value=*/static_cast<unsigned char>(entryInvalid_));
             }
 
             if (enableStorageCache_)
@@ -434,6 +499,22 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableThermodynamicHints, "Enable thermodynamic hints");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityCache, "Turn on caching of intensive quantities");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStorageCache, "Store previous storage terms and avoid re-calculating them.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, PrefillIntensiveQuantityCache,
+                             "Evaluate the intensive quantities of all degrees of freedom "
+                             "before linearizing the system of equations");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityFieldStorage,
+                             "Store the cached intensive quantities field by field instead "
+                             "of as an array of objects");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, IntensiveQuantityFieldStorageSinglePrecision,
+                             "Use single precision for the derivatives of the intensive "
+                             "quantities if they are stored field by field");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, PrintIntensiveQuantityCacheMemoryUsage,
+                             "Print the memory used by the intensive quantity cache at "
+                             "the beginning of the simulation");
+        EWOMS_REGISTER_PARAM(TypeTag, unsigned, PredictorOrder,
+                             "The order of the polynomial used to extrapolate the initial "
+                             "guess of the Newton method from the last time steps "
+                             "(0: none, 1: linear, 2: quadratic)");
     }
 
     /*!
@@ -494,6 +575,27 @@ public:
         // sum up the volumes of the grid partitions
         gridTotalVolume_ = gridView_.comm().sum(gridTotalVolume_);
 
+        // store the global indices of the degrees of freedom of all stencils in the
+        // order in which the elements are traversed, so that the data of the next
+        // element can be prefetched without evaluating its stencil. the size of the
+        // largest stencil is recorded as well.
+        maxNumStencilDof_ = 0;
+        maxNumStencilInteriorFaces_ = 0;
+        pffDofIndices_.reset(new PffDofIndices_(gridView_, asImp_().dofMapper()));
+        pffDofIndices_->update([this](unsigned& globalDofIdx, const Stencil& stencil, unsigned localDofIdx)
+                               {
+                                   globalDofIdx = stencil.globalSpaceIndex(localDofIdx);
+                                   maxNumStencilDof_ =
+                                       std::max<size_t>(maxNumStencilDof_, stencil.numDof());
+                                   maxNumStencilInteriorFaces_ =
+                                       std::max<size_t>(maxNumStencilInteriorFaces_,
+                                                        stencil.numInteriorFaces());
+                               });
+
+        // determine the faces on the domain boundary
+        boundaryFaceTable_.update(asImp_().dofMapper(),
+                                  simulator_.gridManager().gridSequenceNumber());
+
         linearizer_->init(simulator_);
         for (unsigned threadId = 0; threadId < ThreadManager::maxThreads(); ++threadId)
             localLinearizer_[threadId].init(simulator_);
@@ -503,9 +605,48 @@ public:
             // invalidate all cached intensive quantities
             for (unsigned timeIdx = 0; timeIdx < historySize; ++ timeIdx)
                 invalidateIntensiveQuantitiesCache(timeIdx);
+
+            // if requested, report the memory required by the cache to be able to
+            // compare the ways of storing the intensive quantities
+            if (EWOMS_GET_PARAM(TypeTag, bool, PrintIntensiveQuantityCacheMemoryUsage)) {
+                double memoryUsage = static_cast<double>(intensiveQuantityCacheMemoryUsage());
+                memoryUsage = gridView_.comm().sum(memoryUsage);
+                if (verbose_())
+                    std::cout << "The intensive quantity cache uses "
+                              << memoryUsage/(1024*1024) << " MiB\n" << std::flush;
+            }
+        }
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated by the intensive quantity cache of
+     *        the process.
+     */
+    size_t intensiveQuantityCacheMemoryUsage() const
+    {
+        size_t result = 0;
+        for (unsigned timeIdx = 0; timeIdx < historySize; ++ timeIdx) {
+            result += intensiveQuantityCache_[timeIdx].capacity()*sizeof(IntensiveQuantities);
+            result += intensiveQuantityFieldCache_[timeIdx].memoryUsage();
+            result += intensiveQuantityCacheUpToDate_[timeIdx].capacity();
         }
+        return result;
     }
 
+    /*!
+     * \brief Returns the largest number of degrees of freedom of the stencil of any
+     *        element of the grid view.
+     */
+    size_t maxNumStencilDof() const
+    { return maxNumStencilDof_; }
+
+    /*!
+     * \brief Returns the largest number of interior faces of the stencil of any element
+     *        of the grid view.
+     */
+    size_t maxNumStencilInteriorFaces() const
+    { return maxNumStencilInteriorFaces_; }
+
     /*!
      * \brief Returns whether the grid ought to be adapted to the solution during the simulation.
      */
@@ -565,10 +706,30 @@ public:
     /*!
      * \brief Allows to improve the performance by prefetching all data which is
      *        associated with a given element.
+     *
+     * By default, the primary variables and the cached intensive quantities of the
+     * degrees of freedom of the element's stencil are prefetched.
      */
-    void prefetch(const Element& elem OPM_UNUSED) const
+    void prefetch(const Element& elem) const
     {
-        // do nothing by default
+        if (!pffDofIndices_)
+            return;
+
+        unsigned elemIdx = pffDofIndices_->elementIndex(elem);
+        unsigned numDof = pffDofIndices_->numDof(elemIdx);
+        const auto& sol = solution(/*timeIdx=*/0);
+        for (unsigned localDofIdx = 0; localDofIdx < numDof; ++localDofIdx) {
+            unsigned globalDofIdx = pffDofIndices_->get(elemIdx, localDofIdx);
+
+            Ewoms::prefetch(sol[globalDofIdx]);
+            if (storeIntensiveQuantities()) {
+                Ewoms::prefetch(intensiveQuantityCacheUpToDate_[/*timeIdx=*/0][globalDofIdx]);
+                if (useIntensiveQuantityFieldStorage_)
+                    intensiveQuantityFieldCache_[/*timeIdx=*/0].prefetch(globalDofIdx);
+                else
+                    Ewoms::prefetch(intensiveQuantityCache_[/*timeIdx=*/0][globalDofIdx]);
+            }
+        }
     }
 
     /*!
@@ -612,7 +773,9 @@ public:
      *        grid at given time.
      *
      * \attention If no up-to date intensive quantities are available,
-     *            this method will return 0.
+     *            this method will return 0. This is also the case if the cache stores
+     *            the intensive quantities field by field, use
+     *            loadCachedIntensiveQuantities() instead.
      *
      * \param globalIdx The global space index for the entity where a
      *                  hint is requested.
@@ -620,16 +783,41 @@ public:
      */
     const IntensiveQuantities* cachedIntensiveQuantities(unsigned globalIdx, unsigned timeIdx) const
     {
-        if (!enableIntensiveQuantitiesCache_() ||
-            !intensiveQuantityCacheUpToDate_[timeIdx][globalIdx])
+        if (useIntensiveQuantityFieldStorage_)
             return 0;
 
-        if (timeIdx > 0 && enableStorageCache_)
-            // with the storage cache enabled, only the intensive quantities for the most
-            // recent time step are cached!
+        int slotIdx = intensiveQuantityCacheSlot_(globalIdx, timeIdx);
+        if (slotIdx < 0)
             return 0;
 
-        return &intensiveQuantityCache_[timeIdx][globalIdx];
+        return &intensiveQuantityCache_[slotIdx][globalIdx];
+    }
+
+    /*!
+     * \brief Copy the cached intensive quantities for a entity on the grid at given
+     *        time into an object.
+     *
+     * In contrast to cachedIntensiveQuantities(), this also works if the cache stores
+     * the intensive quantities field by field.
+     *
+     * \param intQuants The object which receives the intensive quantities.
+     * \param globalIdx The global space index for the entity.
+     * \param timeIdx The index used by the time discretization.
+     * \return false if no up-to date intensive quantities are available.
+     */
+    bool loadCachedIntensiveQuantities(IntensiveQuantities& intQuants,
+                                       unsigned globalIdx,
+                                       unsigned timeIdx) const
+    {
+        int slotIdx = intensiveQuantityCacheSlot_(globalIdx, timeIdx);
+        if (slotIdx < 0)
+            return false;
+
+        if (useIntensiveQuantityFieldStorage_)
+            intensiveQuantityFieldCache_[slotIdx].load(intQuants, globalIdx);
+        else
+            intQuants = intensiveQuantityCache_[slotIdx][globalIdx];
+        return true;
     }
 
     /*!
@@ -647,8 +835,8 @@ public:
         if (!storeIntensiveQuantities())
             return;
 
-        intensiveQuantityCache_[timeIdx][globalIdx] = intQuants;
-        intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = true;
+        storeIntensiveQuantities_(intQuants, globalIdx, timeIdx);
+        intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = entryValid_;
     }
 
     /*!
@@ -665,7 +853,11 @@ public:
         if (!storeIntensiveQuantities())
             return;
 
-        intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = newValue;
+        unsigned char& entryState = intensiveQuantityCacheUpToDate_[timeIdx][globalIdx];
+        if (!newValue)
+            entryState = entryInvalid_;
+        else if (entryState == entryInvalid_)
+            entryState = entryValid_;
     }
 
     /*!
@@ -678,14 +870,17 @@ public:
         if (storeIntensiveQuantities()) {
             std::fill(intensiveQuantityCacheUpToDate_[timeIdx].begin(),
                       intensiveQuantityCacheUpToDate_[timeIdx].end(),
-                      /*value=*/false);
+                      /*value=*/static_cast<unsigned char>(entryInvalid_));
         }
     }
 
     /*!
      * \brief Move the intensive quantities for a given time index to the back.
      *
-     * This method should only be called by the time discretization.
+     * This method should only be called by the time discretization. The slots of the
+     * cache are organized as a ring, i.e., instead of copying the intensive quantities,
+     * only the storage of the slots is rotated. The most recent slots then refer to the
+     * entries of the slot which was the most recent one before.
      *
      * \param numSlots The number of time step slots for which the
      *                 hints should be shifted.
@@ -702,18 +897,206 @@ public:
             return;
         }
 
-        assert(numSlots > 0);
-
-        for (unsigned timeIdx = 0; timeIdx < historySize - numSlots; ++ timeIdx) {
-            intensiveQuantityCache_[timeIdx + numSlots] = intensiveQuantityCache_[timeIdx];
-            intensiveQuantityCacheUpToDate_[timeIdx + numSlots] = intensiveQuantityCacheUpToDate_[timeIdx];
-        }
+        assert(0 < numSlots && numSlots < historySize);
+
+        // the slots are about to be reused, so entries which refer to another slot must
+        // be materialized first. (usually there are none because the Newton method
+        // invalidates the most recent slot.)
+        for (int timeIdx = historySize - 1; timeIdx >= 0; -- timeIdx)
+            materializeIntensiveQuantityCacheRefs_(static_cast<unsigned>(timeIdx));
+
+        // rotate the slots. this only swaps the internal pointers of the vectors.
+        std::rotate(intensiveQuantityCache_,
+                    intensiveQuantityCache_ + historySize - numSlots,
+                    intensiveQuantityCache_ + historySize);
+        std::rotate(intensiveQuantityFieldCache_,
+                    intensiveQuantityFieldCache_ + historySize - numSlots,
+                    intensiveQuantityFieldCache_ + historySize);
+        std::rotate(intensiveQuantityCacheUpToDate_,
+                    intensiveQuantityCacheUpToDate_ + historySize - numSlots,
+                    intensiveQuantityCacheUpToDate_ + historySize);
 
         // the cache for the most recent time indices do not need to be invalidated
         // because the solution for them did not change (TODO: that assumes that there is
-        // no post-processing of the solution after a time step! fix it?)
+        // no post-processing of the solution after a time step! fix it?). instead of
+        // copying the objects, let them refer to the slot which now holds them.
+        for (unsigned timeIdx = 0; timeIdx < numSlots; ++ timeIdx)
+            referIntensiveQuantityCacheSlot_(timeIdx, /*srcTimeIdx=*/numSlots);
+    }
+
+    /*!
+     * \brief Evaluate the intensive quantities of all degrees of freedom which are not
+     *        up to date in the intensive quantity cache.
+     *
+     * This does nothing unless both the intensive quantity cache and the
+     * PrefillIntensiveQuantityCache parameter are enabled. Each degree of freedom is
+     * evaluated exactly once. The degrees of freedom are sorted by the key returned by
+     * intensiveQuantitiesBatchKey(), so that each thread processes runs of degrees of
+     * freedom that take the same code path and access the same tables.
+     *
+     * \param timeIdx The index used by the time discretization.
+     */
+    void prefillIntensiveQuantityCache(unsigned timeIdx = 0)
+    {
+        if (!enableIntensiveQuantitiesCache_() || !prefillIntensiveQuantityCache_)
+            return;
+
+        if (timeIdx > 0 && enableStorageCache_)
+            // the intensive quantities of previous time steps are not cached
+            return;
+
+        updateIntQuantsWorkList_();
+
+        // collect the degrees of freedom which need to be updated and group them
+        const auto& upToDate = intensiveQuantityCacheUpToDate_[timeIdx];
+        intQuantsPending_.clear();
+        for (unsigned itemIdx = 0; itemIdx < intQuantsWorkList_.size(); ++itemIdx) {
+            auto& item = intQuantsWorkList_[itemIdx];
+            if (upToDate[item.globalDofIdx] != entryInvalid_)
+                continue;
+
+            item.batchKey = asImp_().intensiveQuantitiesBatchKey(item.globalDofIdx, timeIdx);
+            intQuantsPending_.push_back(itemIdx);
+        }
+
+        const auto& workList = intQuantsWorkList_;
+        std::stable_sort(intQuantsPending_.begin(), intQuantsPending_.end(),
+                         [&workList](unsigned a, unsigned b)
+                         { return workList[a].batchKey < workList[b].batchKey; });
+
+        // evaluate the intensive quantities. each thread writes distinct cache entries,
+        // so no locking is required.
+        const auto& grid = gridView_.grid();
+        int numPending = static_cast<int>(intQuantsPending_.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+            for (int i = 0; i < numPending; ++i) {
+                const auto& item = workList[intQuantsPending_[static_cast<unsigned>(i)]];
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                const Element elem = grid.entity(item.elemSeed);
+#else
+                const auto elemPtr = grid.entityPointer(item.elemSeed);
+                const Element& elem = *elemPtr;
+#endif
+                elemCtx.updateStencil(elem);
+                elemCtx.updateIntensiveQuantitiesUncached(item.localDofIdx, timeIdx);
+                storeIntensiveQuantities_(elemCtx.intensiveQuantities(item.localDofIdx, timeIdx),
+                                          item.globalDofIdx,
+                                          timeIdx);
+            }
+        }
+
+        auto& upToDateFlags = intensiveQuantityCacheUpToDate_[timeIdx];
+        for (unsigned itemIdx : intQuantsPending_)
+            upToDateFlags[workList[itemIdx].globalDofIdx] = entryValid_;
     }
 
+    /*!
+     * \brief Evaluate the storage term of the previous time level for all degrees of
+     *        freedom.
+     *
+     * This does nothing unless the storage cache is enabled and its entries are
+     * outdated. The storage term of each degree of freedom is evaluated exactly once
+     * using the solution of the previous time level, so the result neither depends on
+     * the initial guess of the Newton method nor on the element which is used to
+     * evaluate it. (For the vertex-centered finite volume method, each degree of
+     * freedom is shared by multiple elements.) The intensive quantities of the previous
+     * time level are taken from the intensive quantity cache where possible.
+     */
+    void updateStorageCache()
+    {
+        if (!enableStorageCache_ || storageCacheUpToDate_)
+            return;
+
+        updateIntQuantsWorkList_();
+
+        const auto& grid = gridView_.grid();
+        const auto& workList = intQuantsWorkList_;
+        int numItems = static_cast<int>(workList.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            unsigned threadId = ThreadManager::threadId();
+            ElementContext elemCtx(simulator_);
+            // the intensive quantities of the previous time level are required here
+            elemCtx.setEnableStorageCache(false);
+            EqVector storage;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+            for (int i = 0; i < numItems; ++i) {
+                const auto& item = workList[static_cast<unsigned>(i)];
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                const Element elem = grid.entity(item.elemSeed);
+#else
+                const auto elemPtr = grid.entityPointer(item.elemSeed);
+                const Element& elem = *elemPtr;
+#endif
+                elemCtx.updateStencil(elem);
+
+                // the intensive quantity cache is not shifted if the storage term is
+                // cached, so the most recent slot usually still holds the intensive
+                // quantities of the previous time level which were calculated during the
+                // last Newton iteration. they are only re-evaluated if the degree of
+                // freedom was modified since then, e.g. by the predictor, or if the
+                // cached quantities may deviate from the solution because the Newton
+                // method only recalculates them after significant changes.
+                unsigned globalIdx = item.globalDofIdx;
+                const auto& oldPriVars = solution(/*timeIdx=*/1)[globalIdx];
+                if (intensiveQuantityCacheExact_
+                    && solution(/*timeIdx=*/0)[globalIdx] == oldPriVars
+                    && loadCachedIntensiveQuantities(elemCtx.intensiveQuantities(item.localDofIdx,
+                                                                                 /*timeIdx=*/1),
+                                                     globalIdx,
+                                                     /*timeIdx=*/0))
+                    elemCtx.primaryVars(item.localDofIdx, /*timeIdx=*/1) = oldPriVars;
+                else
+                    elemCtx.updateIntensiveQuantitiesUncached(item.localDofIdx, /*timeIdx=*/1);
+
+                storage = 0.0;
+                asImp_().localResidual(threadId).computeStorage(storage,
+                                                                elemCtx,
+                                                                item.localDofIdx,
+                                                                /*timeIdx=*/1);
+                Opm::Valgrind::CheckDefined(storage);
+                storageCache_[/*timeIdx=*/1][item.globalDofIdx] = storage;
+            }
+        }
+
+        storageCacheUpToDate_ = true;
+    }
+
+    /*!
+     * \brief Mark the cached storage terms as outdated.
+     *
+     * This must be called if the solution of the previous time level was modified.
+     */
+    void invalidateStorageCache()
+    { storageCacheUpToDate_ = false; }
+
+    /*!
+     * \brief Returns the key by which the degrees of freedom are grouped when filling the
+     *        intensive quantity cache.
+     *
+     * Models should overload this method if the evaluation of the intensive quantities
+     * of a degree of freedom takes different code paths depending on its state.
+     *
+     * \param globalDofIdx The global index of the degree of freedom.
+     * \param timeIdx The index used by the time discretization.
+     */
+    unsigned intensiveQuantitiesBatchKey(unsigned globalDofIdx OPM_UNUSED,
+                                         unsigned timeIdx OPM_UNUSED) const
+    { return 0; }
+
     /*!
      * \brief Returns true iff the storage term is cached.
      *
@@ -727,8 +1110,8 @@ public:
      * \brief Retrieve an entry of the cache for the storage term.
      *
      * This is supposed to represent a DOF's total amount of conservation quantities per
-     * volume unit at a given time. The user is responsible for making sure that the
-     * value of this is correct and that it can be used before this method is called.
+     * volume unit at a given time. The entries are only valid after updateStorageCache()
+     * has been called.
      *
      * \param globalDofIdx The index of the relevant degree of freedom in a grid-global vector
      * \param timeIdx The relevant index for the time discretization
@@ -784,7 +1167,7 @@ public:
         dest = 0;
 
         OmpMutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+        ElementScheduler elemScheduler(gridView_);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -793,13 +1176,14 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
+            // outdated storage terms of the previous time level must not be used
+            if (!storageCacheUpToDate_)
+                elemCtx.setEnableStorageCache(false);
             LocalEvalBlockVector residual, storageTerm;
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
+            elemScheduler.run([&](const Element& elem) {
                 if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+                    return;
 
                 elemCtx.updateAll(elem);
                 residual.resize(elemCtx.numDof(/*timeIdx=*/0));
@@ -814,7 +1198,7 @@ public:
                         dest[globalI][eqIdx] += Toolbox::value(residual[dofIdx][eqIdx]);
                 }
                 addLock.unlock();
-            }
+            });
         }
 
         // add up the residuals on the process borders
@@ -845,7 +1229,7 @@ public:
         storage = 0;
 
         OmpMutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        ElementScheduler elemScheduler(gridView());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -854,17 +1238,15 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
             LocalEvalBlockVector elemStorage;
 
             // in this method, we need to disable the storage cache because we want to
             // evaluate the storage term for other time indices than the most recent one
             elemCtx.setEnableStorageCache(false);
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
+            elemScheduler.run([&](const Element& elem) {
                 if (elem.partitionType() != Dune::InteriorEntity)
-                    continue; // ignore ghost and overlap elements
+                    return; // ignore ghost and overlap elements
 
                 elemCtx.updateStencil(elem);
                 elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
@@ -879,7 +1261,7 @@ public:
                     for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
                         storage[eqIdx] += Toolbox::value(elemStorage[dofIdx][eqIdx]);
                 addLock.unlock();
-            }
+            });
         }
 
         storage = gridView_.comm().sum(storage);
@@ -1119,6 +1501,39 @@ public:
     Scalar eqWeight(unsigned globalVertexIdx OPM_UNUSED, unsigned eqIdx OPM_UNUSED) const
     { return 1.0; }
 
+    /*!
+     * \brief Returns true iff the primary variables of two time steps can be combined
+     *        to extrapolate the initial guess of the Newton method.
+     *
+     * Models which switch the meaning of their primary variables must make sure that
+     * both vectors use the same one.
+     *
+     * \param pv1 The primary variables of a degree of freedom at a time step
+     * \param pv2 The primary variables of the same degree of freedom at an earlier one
+     */
+    bool canExtrapolate(const PrimaryVariables& pv1 OPM_UNUSED,
+                        const PrimaryVariables& pv2 OPM_UNUSED) const
+    { return true; }
+
+    /*!
+     * \brief Returns true iff the extrapolated primary variables of a degree of freedom
+     *        are a physically meaningful initial guess for the Newton method.
+     *
+     * If this is not the case, the solution of the last time step is used for the
+     * degree of freedom.
+     *
+     * \param globalDofIdx The global index of the degree of freedom
+     * \param pv The extrapolated primary variables
+     */
+    bool isAdmissiblePrediction(unsigned globalDofIdx OPM_UNUSED,
+                                const PrimaryVariables& pv) const
+    {
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+            if (!std::isfinite(pv[pvIdx]))
+                return false;
+        return true;
+    }
+
     /*!
      * \brief Returns the relative error between two vectors of
      *        primary variables.
@@ -1165,6 +1580,8 @@ public:
         updateTimer_.halt();
 
         prePostProcessTimer_.start();
+        if (numPredictorLevels_ > 0)
+            extrapolateSolution_();
         asImp_().updateBegin();
         prePostProcessTimer_.stop();
 
@@ -1281,7 +1698,14 @@ public:
         // previous time step so that we can start the next
         // update at a physically meaningful solution.
         solution(/*timeIdx=*/0) = solution(/*timeIdx=*/1);
-        invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+
+        // the cached intensive quantities of the previous time level are now also the
+        // ones of the current solution. (this does not work if the storage term is
+        // cached because the older slots of the cache are not maintained then.)
+        if (storeIntensiveQuantities() && !enableStorageCache_)
+            referIntensiveQuantityCacheSlot_(/*timeIdx=*/0, /*srcTimeIdx=*/1);
+        else
+            invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
     }
 
     /*!
@@ -1296,8 +1720,14 @@ public:
         // at this point we can adapt the grid
         asImp_().adaptGrid();
 
+        // remember the previous solution for extrapolating the initial guess of the next
+        // time step
+        if (predictorOrder_ > 0)
+            updatePredictorHistory_();
+
         // make the current solution the previous one.
         solution(/*timeIdx=*/1) = solution(/*timeIdx=*/0);
+        invalidateStorageCache();
 
         // shift the intensive quantities cache by one position in the
         // history
@@ -1435,6 +1865,15 @@ public:
     const ElementMapper& elementMapper() const
     { return elementMapper_; }
 
+    /*!
+     * \brief Returns the precomputed faces of all elements which are located on the
+     *        boundary of the domain.
+     *
+     * The table is populated by finishInit().
+     */
+    const BoundaryFaceTable& boundaryFaceTable() const
+    { return boundaryFaceTable_; }
+
     /*!
      * \brief Resets the Jacobian matrix linearizer, so that the
      *        boundary types can be altered.
@@ -1584,18 +2023,16 @@ public:
         }
 
         // iterate over grid
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        ElementScheduler elemScheduler(gridView());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const auto& elem = *elemIt;
+            elemScheduler.run([&](const Element& elem) {
                 if (elem.partitionType() != Dune::InteriorEntity)
                     // ignore non-interior entities
-                    continue;
+                    return;
 
                 if (needFullContextUpdate)
                     elemCtx.updateAll(elem);
@@ -1604,10 +2041,11 @@ public:
                     elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
                 }
 
-                modIt = outputModules_.begin();
-                for (; modIt != modEndIt; ++modIt)
-                    (*modIt)->processElement(elemCtx);
-            }
+                // the iterator must be thread specific
+                auto threadModIt = outputModules_.begin();
+                for (; threadModIt != modEndIt; ++threadModIt)
+                    (*threadModIt)->processElement(elemCtx);
+            });
         }
     }
 
@@ -1726,6 +2164,213 @@ public:
     { return updateTimer_; }
 
 protected:
+    // returns the slot of the intensive quantity cache which holds the up-to-date
+    // intensive quantities of a degree of freedom or -1 if there are none
+    int intensiveQuantityCacheSlot_(unsigned globalIdx, unsigned timeIdx) const
+    {
+        if (!enableIntensiveQuantitiesCache_())
+            return -1;
+
+        unsigned char entryState = intensiveQuantityCacheUpToDate_[timeIdx][globalIdx];
+        if (entryState == entryInvalid_)
+            return -1;
+
+        if (timeIdx > 0 && enableStorageCache_)
+            // with the storage cache enabled, only the intensive quantities for the most
+            // recent time step are cached!
+            return -1;
+
+        if (entryState == entryInOtherSlot_)
+            // the time level was rotated and the entry is still the same as the one
+            // of the slot which was the most recent one before
+            return static_cast<int>(intensiveQuantityCacheRefSlot_[timeIdx]);
+
+        return static_cast<int>(timeIdx);
+    }
+
+    // write the intensive quantities of a degree of freedom to a slot of the cache
+    // without changing the state of the entry
+    void storeIntensiveQuantities_(const IntensiveQuantities& intQuants,
+                                   unsigned globalIdx,
+                                   unsigned timeIdx) const
+    {
+        if (useIntensiveQuantityFieldStorage_)
+            intensiveQuantityFieldCache_[timeIdx].store(globalIdx, intQuants);
+        else
+            intensiveQuantityCache_[timeIdx][globalIdx] = intQuants;
+    }
+
+    // allocate the entries of a slot of the intensive quantity cache
+    void resizeIntensiveQuantityCacheSlot_(unsigned timeIdx, size_t numDof)
+    {
+        if (useIntensiveQuantityFieldStorage_)
+            intensiveQuantityFieldCache_[timeIdx].resize(numDof,
+                                                         EWOMS_GET_PARAM(TypeTag, bool, IntensiveQuantityFieldStorageSinglePrecision));
+        else
+            intensiveQuantityCache_[timeIdx].resize(numDof);
+    }
+
+    // copy the cache entries of a slot which refer to another slot into the slot itself
+    void materializeIntensiveQuantityCacheRefs_(unsigned timeIdx)
+    {
+        auto& states = intensiveQuantityCacheUpToDate_[timeIdx];
+        unsigned srcTimeIdx = intensiveQuantityCacheRefSlot_[timeIdx];
+        for (size_t dofIdx = 0; dofIdx < states.size(); ++ dofIdx) {
+            if (states[dofIdx] != entryInOtherSlot_)
+                continue;
+
+            if (useIntensiveQuantityFieldStorage_)
+                intensiveQuantityFieldCache_[timeIdx].copyEntry(static_cast<unsigned>(dofIdx),
+                                                                intensiveQuantityFieldCache_[srcTimeIdx]);
+            else
+                intensiveQuantityCache_[timeIdx][dofIdx] = intensiveQuantityCache_[srcTimeIdx][dofIdx];
+            states[dofIdx] = entryValid_;
+        }
+    }
+
+    // make the valid entries of a slot of the cache refer to the entries of another
+    // slot. this assumes that the solutions of both time indices are identical.
+    void referIntensiveQuantityCacheSlot_(unsigned timeIdx, unsigned srcTimeIdx)
+    {
+        const auto& srcStates = intensiveQuantityCacheUpToDate_[srcTimeIdx];
+        auto& states = intensiveQuantityCacheUpToDate_[timeIdx];
+        for (size_t dofIdx = 0; dofIdx < states.size(); ++ dofIdx)
+            states[dofIdx] = static_cast<unsigned char>((srcStates[dofIdx] == entryValid_)
+                                                        ? entryInOtherSlot_
+                                                        : entryInvalid_);
+        intensiveQuantityCacheRefSlot_[timeIdx] = srcTimeIdx;
+    }
+
+    // determine an element and a local index for each degree of freedom of the grid.
+    // this only needs to be done if the grid was changed.
+    void updateIntQuantsWorkList_()
+    {
+        int gridSequenceNumber = simulator_.gridManager().gridSequenceNumber();
+        if (intQuantsWorkListGridSequenceNumber_ == gridSequenceNumber)
+            return;
+        intQuantsWorkListGridSequenceNumber_ = gridSequenceNumber;
+
+        size_t numDof = asImp_().numGridDof();
+        std::vector<bool> dofVisited(numDof, false);
+        intQuantsWorkList_.clear();
+        intQuantsWorkList_.reserve(numDof);
+
+        ElementContext elemCtx(simulator_);
+        ElementIterator elemIt = gridView_.template begin<0>();
+        const ElementIterator& elemEndIt = gridView_.template end<0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            elemCtx.updatePrimaryStencil(elem);
+
+            size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+            for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx) {
+                unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                if (dofVisited[globalIdx])
+                    continue;
+                dofVisited[globalIdx] = true;
+
+                IntQuantsWorkItem_ item;
+                item.elemSeed = elem.seed();
+                item.localDofIdx = dofIdx;
+                item.globalDofIdx = globalIdx;
+                item.batchKey = 0;
+                intQuantsWorkList_.push_back(item);
+            }
+        }
+    }
+
+    // keep the solution of the time step before the one which has just been finished
+    void updatePredictorHistory_()
+    {
+        if (enableGridAdaptation_) {
+            // the old solutions are not transferred to the adapted grid
+            numPredictorLevels_ = 0;
+            return;
+        }
+
+        if (predictorOrder_ > 1 && numPredictorLevels_ > 0) {
+            std::swap(predictorSolution_[0], predictorSolution_[1]);
+            predictorDt_[1] = predictorDt_[0];
+        }
+
+        predictorSolution_[0] = solution(/*timeIdx=*/1);
+        predictorDt_[0] = simulator_.timeStepSize();
+        numPredictorLevels_ = std::min(numPredictorLevels_ + 1, predictorOrder_);
+    }
+
+    // extrapolate the solutions of the last time steps to the end of the current one and
+    // use the result as the initial guess of the Newton method. (the current solution is
+    // the one of the last time step at this point.) for the degrees of freedom where the
+    // meaning of the primary variables was switched or where the extrapolated value is
+    // not admissible, a lower order is tried before the solution of the last time step
+    // is kept.
+    void extrapolateSolution_()
+    {
+        unsigned numLevels = numPredictorLevels_;
+        Scalar h = simulator_.timeStepSize();
+        Scalar h1 = predictorDt_[0];
+        Scalar h2 = predictorDt_[1];
+        if (h <= 0.0 || h1 <= 0.0)
+            return;
+        if (h2 <= 0.0)
+            numLevels = 1;
+
+        // the weights of the Lagrange polynomials which interpolate the solutions at
+        // the points in time t - h1 - h2, t - h1 and t evaluated at t + h
+        Scalar linearWeights[2] = { 1.0 + h/h1, -h/h1 };
+        Scalar quadraticWeights[3] = { 0.0, 0.0, 0.0 };
+        if (numLevels > 1) {
+            quadraticWeights[0] = (h + h1)*(h + h1 + h2)/(h1*(h1 + h2));
+            quadraticWeights[1] = -h*(h + h1 + h2)/(h1*h2);
+            quadraticWeights[2] = h*(h + h1)/((h1 + h2)*h2);
+        }
+
+        auto& curSol = asImp_().solution(/*timeIdx=*/0);
+        const auto& prevSol = predictorSolution_[0];
+        const auto& prevPrevSol = predictorSolution_[1];
+        size_t numGridDof = asImp_().numGridDof();
+        if (prevSol.size() < numGridDof
+            || (numLevels > 1 && prevPrevSol.size() < numGridDof))
+            return;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < static_cast<int>(numGridDof); ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            const PrimaryVariables& pv0 = curSol[dofIdx];
+            const PrimaryVariables& pv1 = prevSol[dofIdx];
+            if (!asImp_().canExtrapolate(pv0, pv1))
+                continue;
+
+            PrimaryVariables prediction(pv0);
+            if (numLevels > 1 && asImp_().canExtrapolate(pv1, prevPrevSol[dofIdx])) {
+                const PrimaryVariables& pv2 = prevPrevSol[dofIdx];
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    prediction[pvIdx] =
+                        quadraticWeights[0]*pv0[pvIdx]
+                        + quadraticWeights[1]*pv1[pvIdx]
+                        + quadraticWeights[2]*pv2[pvIdx];
+
+                if (asImp_().isAdmissiblePrediction(dofIdx, prediction)) {
+                    curSol[dofIdx] = prediction;
+                    setIntensiveQuantitiesCacheEntryValidity(dofIdx, /*timeIdx=*/0, false);
+                    continue;
+                }
+            }
+
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                prediction[pvIdx] =
+                    linearWeights[0]*pv0[pvIdx]
+                    + linearWeights[1]*pv1[pvIdx];
+
+            if (asImp_().isAdmissiblePrediction(dofIdx, prediction)) {
+                curSol[dofIdx] = prediction;
+                setIntensiveQuantitiesCacheEntryValidity(dofIdx, /*timeIdx=*/0, false);
+            }
+        }
+    }
+
     void resizeAndResetIntensiveQuantitiesCache_()
     {
         // allocate the storage cache
@@ -1734,13 +2379,14 @@ protected:
             for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
                 storageCache_[timeIdx].resize(numDof);
             }
+            invalidateStorageCache();
         }
 
         // allocate the intensive quantities cache
         if (storeIntensiveQuantities()) {
             size_t numDof = asImp_().numGridDof();
             for(unsigned timeIdx=0; timeIdx<historySize; ++timeIdx) {
-                intensiveQuantityCache_[timeIdx].resize(numDof);
+                resizeIntensiveQuantityCacheSlot_(timeIdx, numDof);
                 intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof);
                 invalidateIntensiveQuantitiesCache(timeIdx);
             }
@@ -1819,8 +2465,48 @@ protected:
 
     // cur is the current iterative solution, prev the converged
     // solution of the previous time step
+    // the states of the entries of the intensive quantity cache. an entry which is in
+    // the 'entryInOtherSlot_' state is valid, but the object is stored in the slot
+    // given by intensiveQuantityCacheRefSlot_.
+    enum {
+        entryInvalid_ = 0,
+        entryValid_ = 1,
+        entryInOtherSlot_ = 2
+    };
+
+    // the slots of the cache are rotated instead of copied when advancing the time level
     mutable IntensiveQuantitiesVector intensiveQuantityCache_[historySize];
-    mutable std::vector<bool> intensiveQuantityCacheUpToDate_[historySize];
+    // the alternative to intensiveQuantityCache_ if the intensive quantities are stored
+    // field by field
+    mutable IntensiveQuantitiesFieldStorage intensiveQuantityFieldCache_[historySize];
+    bool useIntensiveQuantityFieldStorage_;
+    mutable std::vector<unsigned char> intensiveQuantityCacheUpToDate_[historySize];
+    unsigned intensiveQuantityCacheRefSlot_[historySize];
+
+    // the degrees of freedom of the grid and the elements used to evaluate their
+    // intensive quantities if the cache is filled in advance
+    struct IntQuantsWorkItem_
+    {
+        ElementSeed elemSeed;
+        unsigned localDofIdx;
+        unsigned globalDofIdx;
+        unsigned batchKey;
+    };
+    bool prefillIntensiveQuantityCache_;
+    bool intensiveQuantityCacheExact_;
+    int intQuantsWorkListGridSequenceNumber_;
+    std::vector<IntQuantsWorkItem_> intQuantsWorkList_;
+    std::vector<unsigned> intQuantsPending_;
+
+    // the global indices of the degrees of freedom of each element's stencil in
+    // traversal order. this is used to prefetch the data of the next element.
+    typedef Ewoms::PffGridVector<GridView, Stencil, unsigned, DofMapper> PffDofIndices_;
+    std::unique_ptr<PffDofIndices_> pffDofIndices_;
+    size_t maxNumStencilDof_;
+    size_t maxNumStencilInteriorFaces_;
+
+    // the faces of all elements which are located on the boundary of the domain
+    BoundaryFaceTable boundaryFaceTable_;
 
     DiscreteFunctionSpace space_;
     mutable std::array< std::unique_ptr< DiscreteFunction >, historySize > solution_;
@@ -1838,8 +2524,18 @@ protected:
     std::vector<bool> isLocalDof_;
 
     bool enableGridAdaptation_;
+
+    // the solutions of the time steps before the last one and the sizes of the time
+    // steps which followed them. these are used to extrapolate the initial guess of the
+    // Newton method.
+    unsigned predictorOrder_;
+    unsigned numPredictorLevels_;
+    SolutionVector predictorSolution_[2];
+    Scalar predictorDt_[2];
+
     mutable GlobalEqVector storageCache_[historySize];
     bool enableStorageCache_;
+    bool storageCacheUpToDate_;
 };
 } // namespace Ewoms
 
@@ -65,6 +65,11 @@ class FvBaseElementContext
         IntensiveQuantities intensiveQuantities[timeDiscHistorySize];
         PrimaryVariables priVars[timeDiscHistorySize];
         const IntensiveQuantities *thermodynamicHint[timeDiscHistorySize];
+#ifndef NDEBUG
+        // specifies whether the intensive quantities of a previous time index have been
+        // updated for the current element
+        bool intensiveQuantitiesUpToDate[timeDiscHistorySize];
+#endif
     };
     typedef std::vector<DofStore_> DofVarsVector;
     typedef std::vector<ExtensiveQuantities> ExtensiveQuantitiesVector;
@@ -144,6 +149,30 @@ public:
         // resize the arrays containing the flux and the volume variables
         dofVars_.resize(stencil_.numDof());
         extensiveQuantities_.resize(stencil_.numInteriorFaces());
+
+        invalidateHistoryIntensiveQuantities_();
+    }
+
+    /*!
+     * \brief Specify the position of the element which is passed to the next update of
+     *        the stencil in the iteration order of the grid view.
+     *
+     * This is only a hint which can be exploited by stencils that use precomputed data.
+     * By default, it is ignored.
+     */
+    void setElementRow(unsigned row OPM_UNUSED)
+    { }
+
+    /*!
+     * \brief Allocate the memory required for a stencil of a given size.
+     *
+     * If this is called with the size of the largest stencil of the grid, updating the
+     * context does not allocate any memory.
+     */
+    void reserve(size_t numDof, size_t numInteriorFaces)
+    {
+        dofVars_.reserve(numDof);
+        extensiveQuantities_.reserve(numInteriorFaces);
     }
 
     /*!
@@ -161,6 +190,8 @@ public:
         stencil_.updatePrimaryTopology(elem);
 
         dofVars_.resize(stencil_.numPrimaryDof());
+
+        invalidateHistoryIntensiveQuantities_();
     }
 
     /*!
@@ -176,6 +207,8 @@ public:
 
         // update the finite element geometry
         stencil_.updateTopology(elem);
+
+        invalidateHistoryIntensiveQuantities_();
     }
 
     /*!
@@ -187,8 +220,14 @@ public:
         if (!enableStorageCache_) {
             // if the storage cache is disabled, we need to calculate the storage term
             // from scratch, i.e. we need the intensive quantities of all of the history.
-            for (unsigned timeIdx = 0; timeIdx < timeDiscHistorySize; ++ timeIdx)
-                asImp_().updateIntensiveQuantities(timeIdx);
+            // since fluxes are only evaluated for the most recent time index, the
+            // storage term of the previous ones only needs the primary degrees of
+            // freedom. (for the element centered finite volume method this avoids
+            // re-evaluating the old intensive quantities of all neighbors of every
+            // element.)
+            asImp_().updateIntensiveQuantities(/*timeIdx=*/0);
+            for (unsigned timeIdx = 1; timeIdx < timeDiscHistorySize; ++ timeIdx)
+                asImp_().updatePrimaryIntensiveQuantities(timeIdx);
         }
         else
             // if the storage cache is enabled, we only need to recalculate the storage
@@ -228,6 +267,24 @@ public:
     void updateIntensiveQuantities(const PrimaryVariables& priVars, unsigned dofIdx, unsigned timeIdx)
     { asImp_().updateSingleIntQuants_(priVars, dofIdx, timeIdx); }
 
+    /*!
+     * \brief Compute the intensive quantities of a single sub-control volume of the
+     *        current element from the global solution.
+     *
+     * In contrast to updateIntensiveQuantities(), the intensive quantity cache of the
+     * model is neither used nor updated.
+     *
+     * \param dofIdx The local index in the current element of the sub-control volume
+     *               which should be updated.
+     * \param timeIdx The index of the solution vector used by the time discretization.
+     */
+    void updateIntensiveQuantitiesUncached(unsigned dofIdx, unsigned timeIdx)
+    {
+        unsigned globalIdx = globalSpaceIndex(dofIdx, timeIdx);
+        dofVars_[dofIdx].thermodynamicHint[timeIdx] = model().thermodynamicHint(globalIdx, timeIdx);
+        asImp_().updateSingleIntQuants_(model().solution(timeIdx)[globalIdx], dofIdx, timeIdx);
+    }
+
     /*!
      * \brief Compute the extensive quantities of all sub-control volume
      *        faces of the current element for all time indices.
@@ -389,7 +446,15 @@ public:
      *        boundary.
      */
     bool onBoundary() const
-    { return element().hasBoundaryIntersections(); }
+    {
+        // use the precomputed boundary faces if they are available
+        const auto& boundaryFaceTable = model().boundaryFaceTable();
+        if (!boundaryFaceTable.isUpToDate(simulator().gridManager().gridSequenceNumber()))
+            return element().hasBoundaryIntersections();
+
+        unsigned elemIdx = boundaryFaceTable.elementIndex(element());
+        return boundaryFaceTable.numBoundaryFaces(elemIdx) > 0;
+    }
 
     /*!
      * \brief Return a reference to the intensive quantities of a
@@ -398,6 +463,13 @@ public:
      * If the time step index is not given, return the volume
      * variables for the current time.
      *
+     * For time indices larger than zero, only the intensive quantities which have been
+     * updated since the stencil was last updated are valid. In particular,
+     * updateAllIntensiveQuantities() only updates the previous time levels of the
+     * primary degrees of freedom, so the ones of the remaining degrees of freedom are
+     * left over from a previous element. In debug builds, accessing them triggers an
+     * assertion.
+     *
      * \param dofIdx The local index of the degree of freedom in the current element.
      * \param timeIdx The index of the solution vector used by the time discretization.
      */
@@ -410,6 +482,8 @@ public:
             OPM_THROW(std::logic_error,
                       "If caching of the storage term is enabled, only the intensive quantities "
                       "for the most-recent substep (i.e. time index 0) are available!");
+
+        assert(timeIdx == 0 || dofVars_[dofIdx].intensiveQuantitiesUpToDate[timeIdx]);
 #endif
 
         return dofVars_[dofIdx].intensiveQuantities[timeIdx];
@@ -430,10 +504,16 @@ public:
     }
     /*!
      * \copydoc intensiveQuantities()
+     *
+     * The caller of this method is expected to update the returned object, i.e.,
+     * afterwards it is considered to be valid.
      */
     IntensiveQuantities& intensiveQuantities(unsigned dofIdx, unsigned timeIdx)
     {
         assert(0 <= dofIdx && dofIdx < numDof(timeIdx));
+#ifndef NDEBUG
+        dofVars_[dofIdx].intensiveQuantitiesUpToDate[timeIdx] = true;
+#endif
         return dofVars_[dofIdx].intensiveQuantities[timeIdx];
     }
 
@@ -563,16 +643,17 @@ protected:
             dofVars_[dofIdx].thermodynamicHint[timeIdx] =
                 model().thermodynamicHint(globalIdx, timeIdx);
 
-            const auto *cachedIntQuants = model().cachedIntensiveQuantities(globalIdx, timeIdx);
-            if (cachedIntQuants) {
-                dofVars_[dofIdx].intensiveQuantities[timeIdx] = *cachedIntQuants;
-            }
-            else {
+            if (!model().loadCachedIntensiveQuantities(dofVars_[dofIdx].intensiveQuantities[timeIdx],
+                                                       globalIdx,
+                                                       timeIdx)) {
                 updateSingleIntQuants_(dofSol, dofIdx, timeIdx);
                 model().updateCachedIntensiveQuantities(dofVars_[dofIdx].intensiveQuantities[timeIdx],
                                                         globalIdx,
                                                         timeIdx);
             }
+#ifndef NDEBUG
+            dofVars_[dofIdx].intensiveQuantitiesUpToDate[timeIdx] = true;
+#endif
         }
     }
 
@@ -587,6 +668,21 @@ protected:
 
         dofVars_[dofIdx].priVars[timeIdx] = priVars;
         dofVars_[dofIdx].intensiveQuantities[timeIdx].update(/*context=*/asImp_(), dofIdx, timeIdx);
+#ifndef NDEBUG
+        dofVars_[dofIdx].intensiveQuantitiesUpToDate[timeIdx] = true;
+#endif
+    }
+
+    // mark the intensive quantities of the previous time levels as outdated. this is
+    // only done in debug builds to catch accesses to the ones which are not updated by
+    // updateAllIntensiveQuantities().
+    void invalidateHistoryIntensiveQuantities_()
+    {
+#ifndef NDEBUG
+        for (auto& dofStore : dofVars_)
+            for (unsigned timeIdx = 1; timeIdx < timeDiscHistorySize; ++timeIdx)
+                dofStore.intensiveQuantitiesUpToDate[timeIdx] = false;
+#endif
     }
 
     IntensiveQuantities intensiveQuantitiesStashed_;
@@ -40,6 +40,7 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
 #include <limits>
 
 namespace Ewoms {
@@ -193,6 +194,11 @@ public:
         simulatorPtr_ = &simulator;
         delete internalElemContext_;
         internalElemContext_ = new ElementContext(simulator);
+
+        // allocate the memory for the largest stencil of the grid up front
+        size_t maxNumDof = simulator.model().maxNumStencilDof();
+        residual_.reserve(maxNumDof);
+        derivResidual_.reserve(maxNumDof);
     }
 
     /*!
@@ -340,7 +346,13 @@ protected:
         size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
 
         residual_.resize(numDof);
-        jacobian_.setSize(numDof, numPrimaryDof);
+
+        // resizing a Dune::Matrix always reallocates its memory. the local Jacobian is
+        // thus only enlarged if needed and the blocks outside of the current stencil
+        // are ignored.
+        if (jacobian_.N() < numDof || jacobian_.M() < numPrimaryDof)
+            jacobian_.setSize(std::max<size_t>(jacobian_.N(), numDof),
+                              std::max<size_t>(jacobian_.M(), numPrimaryDof));
 
         derivResidual_.resize(numDof);
     }
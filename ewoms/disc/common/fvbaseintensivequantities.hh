@@ -89,6 +89,16 @@ public:
     void checkDefined() const
     { }
 
+protected:
+    /*!
+     * \brief Set the extrusion factor without asking the problem.
+     *
+     * This is used to reconstruct intensive quantities objects which were stored field
+     * by field.
+     */
+    void setExtrusionFactor_(Scalar value)
+    { extrusionFactor_ = value; }
+
 private:
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
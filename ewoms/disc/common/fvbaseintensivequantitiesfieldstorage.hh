@@ -0,0 +1,277 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::FvBaseIntensiveQuantitiesFieldStorage
+ */
+#ifndef EWOMS_FV_BASE_INTENSIVE_QUANTITIES_FIELD_STORAGE_HH
+#define EWOMS_FV_BASE_INTENSIVE_QUANTITIES_FIELD_STORAGE_HH
+
+#include "fvbaseproperties.hh"
+
+#include <ewoms/common/prefetch.hh>
+
+#include <opm/common/Unused.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Ewoms {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Stores a quantity of type Evaluation for each degree of freedom of the grid.
+ *
+ * The values and the derivatives are stored in separate arrays. Optionally, the
+ * derivatives are stored using single precision. Since the derivatives only end up in
+ * the Jacobian matrix, this does not affect the residual, but only the convergence rate
+ * of the Newton method.
+ */
+template <class Evaluation, bool isScalar = std::is_floating_point<Evaluation>::value>
+class EvaluationFieldArray
+{
+    // Evaluation is a DenseAd::Evaluation
+    typedef typename Evaluation::ValueType Scalar;
+    static const unsigned numDerivatives = Evaluation::size;
+
+public:
+    EvaluationFieldArray()
+        : singlePrecisionDerivatives_(false)
+    {}
+
+    /*!
+     * \brief Allocate the storage for a given number of degrees of freedom.
+     */
+    void resize(size_t numDof, bool singlePrecisionDerivatives)
+    {
+        singlePrecisionDerivatives_ = singlePrecisionDerivatives;
+        values_.resize(numDof);
+        if (singlePrecisionDerivatives_) {
+            std::vector<Scalar>().swap(derivatives_);
+            floatDerivatives_.resize(numDof*numDerivatives);
+        }
+        else {
+            derivatives_.resize(numDof*numDerivatives);
+            std::vector<float>().swap(floatDerivatives_);
+        }
+    }
+
+    /*!
+     * \brief Set the quantity of a degree of freedom.
+     */
+    void store(unsigned dofIdx, const Evaluation& eval)
+    {
+        values_[dofIdx] = eval.value();
+        if (singlePrecisionDerivatives_) {
+            float* derivs = floatDerivatives_.data() + dofIdx*numDerivatives;
+            for (unsigned i = 0; i < numDerivatives; ++i)
+                derivs[i] = static_cast<float>(eval.derivative(i));
+        }
+        else {
+            Scalar* derivs = derivatives_.data() + dofIdx*numDerivatives;
+            for (unsigned i = 0; i < numDerivatives; ++i)
+                derivs[i] = eval.derivative(i);
+        }
+    }
+
+    /*!
+     * \brief Reconstruct the quantity of a degree of freedom.
+     */
+    void load(Evaluation& eval, unsigned dofIdx) const
+    {
+        eval.setValue(values_[dofIdx]);
+        if (singlePrecisionDerivatives_) {
+            const float* derivs = floatDerivatives_.data() + dofIdx*numDerivatives;
+            for (unsigned i = 0; i < numDerivatives; ++i)
+                eval.setDerivative(i, static_cast<Scalar>(derivs[i]));
+        }
+        else {
+            const Scalar* derivs = derivatives_.data() + dofIdx*numDerivatives;
+            for (unsigned i = 0; i < numDerivatives; ++i)
+                eval.setDerivative(i, derivs[i]);
+        }
+    }
+
+    /*!
+     * \brief Returns the value of the quantity of a degree of freedom.
+     */
+    Scalar value(unsigned dofIdx) const
+    { return values_[dofIdx]; }
+
+    /*!
+     * \brief Copy the quantity of a degree of freedom from another array.
+     */
+    void copyEntry(unsigned dofIdx, const EvaluationFieldArray& other)
+    {
+        assert(singlePrecisionDerivatives_ == other.singlePrecisionDerivatives_);
+
+        values_[dofIdx] = other.values_[dofIdx];
+        size_t offset = dofIdx*numDerivatives;
+        if (singlePrecisionDerivatives_)
+            std::copy(other.floatDerivatives_.begin() + static_cast<long>(offset),
+                      other.floatDerivatives_.begin() + static_cast<long>(offset + numDerivatives),
+                      floatDerivatives_.begin() + static_cast<long>(offset));
+        else
+            std::copy(other.derivatives_.begin() + static_cast<long>(offset),
+                      other.derivatives_.begin() + static_cast<long>(offset + numDerivatives),
+                      derivatives_.begin() + static_cast<long>(offset));
+    }
+
+    /*!
+     * \brief Prefetch the quantity of a degree of freedom.
+     */
+    void prefetch(unsigned dofIdx) const
+    {
+        Ewoms::prefetch(values_[dofIdx]);
+        if (singlePrecisionDerivatives_)
+            Ewoms::prefetch(floatDerivatives_[dofIdx*numDerivatives], numDerivatives);
+        else
+            Ewoms::prefetch(derivatives_[dofIdx*numDerivatives], numDerivatives);
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated by the array.
+     */
+    size_t memoryUsage() const
+    {
+        return
+            values_.capacity()*sizeof(Scalar)
+            + derivatives_.capacity()*sizeof(Scalar)
+            + floatDerivatives_.capacity()*sizeof(float);
+    }
+
+private:
+    bool singlePrecisionDerivatives_;
+    std::vector<Scalar> values_;
+    std::vector<Scalar> derivatives_;
+    std::vector<float> floatDerivatives_;
+};
+
+//! \cond SKIP_THIS
+// if the evaluations are plain floating point values (i.e., finite differences are used
+// to linearize the system of equations), there are no derivatives to be stored
+template <class Evaluation>
+class EvaluationFieldArray<Evaluation, /*isScalar=*/true>
+{
+public:
+    void resize(size_t numDof, bool singlePrecisionDerivatives OPM_UNUSED)
+    { values_.resize(numDof); }
+
+    void store(unsigned dofIdx, const Evaluation& eval)
+    { values_[dofIdx] = eval; }
+
+    void load(Evaluation& eval, unsigned dofIdx) const
+    { eval = values_[dofIdx]; }
+
+    Evaluation value(unsigned dofIdx) const
+    { return values_[dofIdx]; }
+
+    void copyEntry(unsigned dofIdx, const EvaluationFieldArray& other)
+    { values_[dofIdx] = other.values_[dofIdx]; }
+
+    void prefetch(unsigned dofIdx) const
+    { Ewoms::prefetch(values_[dofIdx]); }
+
+    size_t memoryUsage() const
+    { return values_.capacity()*sizeof(Evaluation); }
+
+private:
+    std::vector<Evaluation> values_;
+};
+//! \endcond
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Stores the intensive quantities of all degrees of freedom of the grid field
+ *        by field.
+ *
+ * Instead of keeping an array of IntensiveQuantities objects, the cache of the model
+ * can use a class like this which keeps a separate array for each of the quantities
+ * which are needed by the storage and flux terms. This avoids storing the members of
+ * the objects which can be derived from others, and it allows to store the derivatives
+ * using single precision.
+ *
+ * Since this depends on the internals of the intensive quantities, it must be
+ * implemented by the physical model. This class is the default which is used by the
+ * models that do not support it.
+ */
+template <class TypeTag>
+class FvBaseIntensiveQuantitiesFieldStorage
+{
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+
+public:
+    /*!
+     * \brief Returns true if the intensive quantities of the model can be stored field
+     *        by field.
+     */
+    static bool isSupported()
+    { return false; }
+
+    /*!
+     * \brief Allocate the storage for a given number of degrees of freedom.
+     */
+    void resize(size_t numDof OPM_UNUSED, bool singlePrecisionDerivatives OPM_UNUSED)
+    {}
+
+    /*!
+     * \brief Store the intensive quantities of a degree of freedom.
+     */
+    void store(unsigned dofIdx OPM_UNUSED, const IntensiveQuantities& intQuants OPM_UNUSED)
+    { assert(false); }
+
+    /*!
+     * \brief Reconstruct the intensive quantities of a degree of freedom.
+     */
+    void load(IntensiveQuantities& intQuants OPM_UNUSED, unsigned dofIdx OPM_UNUSED) const
+    { assert(false); }
+
+    /*!
+     * \brief Copy the intensive quantities of a degree of freedom from another object.
+     */
+    void copyEntry(unsigned dofIdx OPM_UNUSED,
+                   const FvBaseIntensiveQuantitiesFieldStorage& other OPM_UNUSED)
+    { assert(false); }
+
+    /*!
+     * \brief Prefetch the intensive quantities of a degree of freedom.
+     */
+    void prefetch(unsigned dofIdx OPM_UNUSED) const
+    {}
+
+    /*!
+     * \brief Returns the number of bytes allocated by the object.
+     */
+    size_t memoryUsage() const
+    { return 0; }
+};
+
+} // namespace Ewoms
+
+#endif
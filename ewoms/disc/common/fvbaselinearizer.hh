@@ -29,11 +29,14 @@
 #define EWOMS_FV_BASE_LINEARIZER_HH
 
 #include "fvbaseproperties.hh"
+#include "fvbaseconstraintsmap.hh"
 
 #include <ewoms/parallel/gridcommhandles.hh>
 #include <ewoms/parallel/threadmanager.hh>
-#include <ewoms/parallel/threadedentityiterator.hh>
+#include <ewoms/parallel/threadedentityscheduler.hh>
+#include <ewoms/parallel/parallelzero.hh>
 #include <ewoms/aux/baseauxiliarymodule.hh>
+#include <ewoms/linear/sparsitypattern.hh>
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
@@ -43,9 +46,12 @@
 #include <dune/common/fmatrix.hh>
 
 #include <type_traits>
+#include <algorithm>
 #include <iostream>
+#include <cassert>
+#include <memory>
 #include <vector>
-#include <set>
+#include <utility>
 
 namespace Ewoms {
 // forward declarations
@@ -81,6 +87,7 @@ class FvBaseLinearizer
     typedef typename GET_PROP_TYPE(TypeTag, JacobianMatrix) JacobianMatrix;
     typedef typename GET_PROP_TYPE(TypeTag, EqVector) EqVector;
     typedef typename GET_PROP_TYPE(TypeTag, Constraints) Constraints;
+    typedef Ewoms::FvBaseConstraintsMap<TypeTag> ConstraintsMap;
     typedef typename GET_PROP_TYPE(TypeTag, Stencil) Stencil;
     typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
 
@@ -90,6 +97,7 @@ class FvBaseLinearizer
 
     typedef typename GridView::template Codim<0>::Entity Element;
     typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+    typedef Ewoms::ThreadedEntityScheduler<GridView, /*codim=*/0> ElementScheduler;
 
     typedef GlobalEqVector Vector;
     typedef JacobianMatrix Matrix;
@@ -99,6 +107,7 @@ class FvBaseLinearizer
 
     typedef Dune::FieldMatrix<Scalar, numEq, numEq> MatrixBlock;
     typedef Dune::FieldVector<Scalar, numEq> VectorBlock;
+    typedef typename Matrix::block_type MatrixStorageBlock;
 
     static const bool linearizeNonLocalElements = GET_PROP_VALUE(TypeTag, LinearizeNonLocalElements);
 
@@ -112,6 +121,9 @@ public:
         simulatorPtr_ = 0;
 
         matrix_ = 0;
+        useColoredLinearization_ = false;
+        useScatterMap_ = false;
+        scatterMapGridSequenceNumber_ = -1;
     }
 
     ~FvBaseLinearizer()
@@ -127,7 +139,14 @@ public:
      * \brief Register all run-time parameters for the Jacobian linearizer.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableColoredLinearization,
+                             "Partition the elements into colors which do not share any "
+                             "degree of freedom and linearize them without locking");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableJacobianScatterMap,
+                             "Precompute the addresses of the Jacobian matrix blocks "
+                             "which are touched by each element");
+    }
 
     /*!
      * \brief Initialize the linearizer.
@@ -143,6 +162,14 @@ public:
         simulatorPtr_ = &simulator;
         delete matrix_; // <- note that this even works for nullpointers!
         matrix_ = 0;
+
+        // coloring the elements only makes sense if the global linear system would need
+        // to be locked otherwise
+        useColoredLinearization_ =
+            GET_PROP_VALUE(TypeTag, UseLinearizationLock)
+            && EWOMS_GET_PARAM(TypeTag, bool, EnableColoredLinearization);
+
+        useScatterMap_ = EWOMS_GET_PARAM(TypeTag, bool, EnableJacobianScatterMap);
     }
 
     /*!
@@ -156,6 +183,10 @@ public:
     {
         delete matrix_; // <- note that this even works for nullpointers!
         matrix_ = 0;
+
+        // the scatter map points into the matrix, so it must be recreated as well
+        scatterMapOffsets_.clear();
+        scatterMap_.clear();
     }
 
     /*!
@@ -172,43 +203,43 @@ public:
         // we defer the initialization of the Jacobian matrix until here because the
         // auxiliary modules usually assume the problem, model and grid to be fully
         // initialized...
+        if (useScatterMap_
+            && scatterMapGridSequenceNumber_ != simulator_().gridManager().gridSequenceNumber())
+            // the grid has changed since the scatter map was created. since the
+            // structure of the matrix is invalid as well, start from scratch.
+            eraseMatrix();
+
         if (!matrix_)
             initFirstIteration_();
 
-        int succeeded;
-        try {
-            linearize_();
-            succeeded = 1;
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "rank " << simulator_().gridView().comm().rank()
-                      << " caught an exception while linearizing:" << e.what()
-                      << "\n"  << std::flush;
-            succeeded = 0;
-        }
-#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2, 5)
-        catch (const Dune::Exception& e)
-        {
-            std::cout << "rank " << simulator_().gridView().comm().rank()
-                      << " caught an exception while linearizing:" << e.what()
-                      << "\n"  << std::flush;
-            succeeded = 0;
-        }
-#endif
-        catch (...)
-        {
-            std::cout << "rank " << simulator_().gridView().comm().rank()
-                      << " caught an exception while linearizing"
-                      << "\n"  << std::flush;
-            succeeded = 0;
-        }
-        succeeded = gridView_().comm().min(succeeded);
+        runOnAllProcesses_([this]() { linearize_(); });
+    }
 
-        if (!succeeded) {
-            OPM_THROW(Opm::NumericalProblem,
-                       "A process did not succeed in linearizing the system");
-        }
+    /*!
+     * \brief Evaluate the residual of the global non-linear system of equations but do
+     *        not linearize it
+     *
+     * Afterwards, residual() contains the residual for the current solution while the
+     * Jacobian matrix is not touched. Compared to linearize(), this does not extract the
+     * partial derivatives from the local residuals, does not zero and scatter into the
+     * Jacobian matrix and it evaluates the local residual of each element only once
+     * instead of once per primary degree of freedom. This makes it suitable for
+     * re-evaluating the residual after a solution update, e.g., for line searches or
+     * convergence checks.
+     *
+     * Note that the intensive and extensive quantities are still evaluated using the
+     * Evaluation type of the model, i.e., including the derivatives if automatic
+     * differentiation is used. For discretizations with a single primary degree of
+     * freedom per element like the element centered finite volume method, this method is
+     * thus not significantly cheaper than linearize(): only the matrix assembly is
+     * skipped.
+     */
+    void linearizeResidual()
+    {
+        if (!matrix_)
+            initFirstIteration_();
+
+        runOnAllProcesses_([this]() { linearizeResidual_(); });
     }
 
     /*!
@@ -229,12 +260,20 @@ public:
     GlobalEqVector& residual()
     { return residual_; }
 
+    /*!
+     * \brief Returns the number of colors used to linearize the elements.
+     *
+     * This is zero if colored linearization is disabled.
+     */
+    size_t numElementColors() const
+    { return elementColors_.size(); }
+
     /*!
      * \brief Returns the map of constraint degrees of freedom.
      *
      * (This object is only non-empty if the EnableConstraints property is true.)
      */
-    const std::map<unsigned, Constraints>& constraintsMap() const
+    const ConstraintsMap& constraintsMap() const
     { return constraintsMap_; }
 
 private:
@@ -264,18 +303,29 @@ private:
 
     void initFirstIteration_()
     {
+        // flatten the grid view so that the elements can be distributed to the threads
+        elementScheduler_.reset(new ElementScheduler(gridView_()));
+
         // initialize the BCRS matrix for the Jacobian of the residual function
         createMatrix_();
 
+        // partition the elements into independent sets
+        updateElementColoring_();
+
+        // precompute the addresses of the matrix blocks touched by each element
+        updateScatterMap_();
+
         // initialize the Jacobian matrix and the vector for the residual function
-        (*matrix_) = 0.0;
         residual_.resize(model_().numTotalDof());
-        residual_ = 0;
+        resetSystem_();
 
         // create the per-thread context objects
         elementCtx_.resize(ThreadManager::maxThreads());
-        for (unsigned threadId = 0; threadId != ThreadManager::maxThreads(); ++ threadId)
+        for (unsigned threadId = 0; threadId != ThreadManager::maxThreads(); ++ threadId) {
             elementCtx_[threadId] = new ElementContext(simulator_());
+            elementCtx_[threadId]->reserve(model_().maxNumStencilDof(),
+                                           model_().maxNumStencilInteriorFaces());
+        }
     }
 
     // Construct the BCRS matrix for the Jacobian of the residual function
@@ -283,60 +333,115 @@ private:
     {
         size_t numAllDof =  model_().numTotalDof();
 
-        // allocate raw matrix
-        matrix_ = new Matrix(numAllDof, numAllDof, Matrix::random);
-
-        Stencil stencil(gridView_(), model_().dofMapper() );
+        // collect the additional neighbors caused by the auxiliary equations. these are
+        // usually only a few, so this is done sequentially
+        typedef std::pair<unsigned, unsigned> NeighborPair;
+        std::vector<NeighborPair> auxNeighbors;
+        const auto& model = model_();
+        size_t numAuxMod = model.numAuxiliaryModules();
+        for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
+            model.auxiliaryModule(auxModIdx)->addNeighbors(auxNeighbors);
 
         // for the main model, find out the global indices of the neighboring degrees of
-        // freedom of each primary degree of freedom
-        typedef std::set<unsigned> NeighborSet;
-        std::vector<NeighborSet> neighbors(numAllDof);
-        ElementIterator elemIt = gridView_().template begin<0>();
-        const ElementIterator elemEndIt = gridView_().template end<0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-            stencil.update(elem);
+        // freedom of each primary degree of freedom. (each degree of freedom talks to
+        // all of its neighbors. it also talks to itself since degrees of freedom are
+        // sometimes quite egocentric.) this is done in two passes: the first one
+        // determines the maximum number of entries of each row, the second one adds the
+        // column indices.
+        Linear::SparsityPattern pattern;
+        pattern.reset(numAllDof);
+        addNeighborsToPattern_(pattern, /*countOnly=*/true);
+        for (const auto& auxNeighbor : auxNeighbors)
+            pattern.countEntries(auxNeighbor.first, /*numEntries=*/1);
+
+        pattern.beginFill();
+        addNeighborsToPattern_(pattern, /*countOnly=*/false);
+        for (const auto& auxNeighbor : auxNeighbors)
+            pattern.addEntry(auxNeighbor.first, auxNeighbor.second);
+
+        pattern.finalize();
+
+        // allocate raw matrix and set its structure
+        matrix_ = new Matrix(numAllDof, numAllDof, Matrix::random);
+        pattern.setupMatrix(*matrix_);
+    }
 
+    // add the connections between the degrees of freedom of each element's stencil to
+    // a sparsity pattern. if 'countOnly' is true, only the space required for them is
+    // reserved.
+    void addNeighborsToPattern_(Linear::SparsityPattern& pattern, bool countOnly)
+    {
+        forEachElementStencil_([&pattern, countOnly](const Element&, const Stencil& stencil) {
+            unsigned numDof = stencil.numDof();
             for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
                 unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
 
-                for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                if (countOnly) {
+                    pattern.countEntries(myIdx, numDof);
+                    continue;
+                }
+
+                for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
                     unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
-                    neighbors[myIdx].insert(neighborIdx);
+                    pattern.addEntry(myIdx, neighborIdx);
                 }
             }
-        }
+        });
+    }
 
-        // add the additional neighbors and degrees of freedom caused by the auxiliary
-        // equations
-        const auto& model = model_();
-        size_t numAuxMod = model.numAuxiliaryModules();
-        for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
-            model.auxiliaryModule(auxModIdx)->addNeighbors(neighbors);
-
-        // allocate space for the rows of the matrix
-        for (unsigned dofIdx = 0; dofIdx < numAllDof; ++ dofIdx)
-            matrix_->setrowsize(dofIdx, neighbors[dofIdx].size());
-        matrix_->endrowsizes();
-
-        // fill the rows with indices. each degree of freedom talks to
-        // all of its neighbors. (it also talks to itself since
-        // degrees of freedom are sometimes quite egocentric.)
-        for (unsigned dofIdx = 0; dofIdx < numAllDof; ++ dofIdx) {
-            typename NeighborSet::iterator nIt = neighbors[dofIdx].begin();
-            typename NeighborSet::iterator nEndIt = neighbors[dofIdx].end();
-            for (; nIt != nEndIt; ++nIt)
-                matrix_->addindex(dofIdx, *nIt);
+    // partition the elements into colors such that no two elements of the same color
+    // share a degree of freedom. since each element only scatters into the rows of the
+    // degrees of freedom of its stencil, the elements of a color can be linearized
+    // concurrently without any locking.
+    void updateElementColoring_()
+    {
+        elementColors_.clear();
+        if (!useColoredLinearization_)
+            return;
+
+        // the colors of the elements which touch a given degree of freedom
+        std::vector<std::vector<unsigned> > dofColors(model_().numGridDof());
+        std::vector<bool> colorTaken;
+
+        Stencil stencil(gridView_(), model_().dofMapper() );
+        ElementIterator elemIt = gridView_().template begin<0>();
+        const ElementIterator elemEndIt = gridView_().template end<0>();
+        for (unsigned elemRow = 0; elemIt != elemEndIt; ++elemIt, ++elemRow) {
+            const Element& elem = *elemIt;
+            if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            stencil.updateTopology(elem);
+
+            // mark all colors of the elements which share a degree of freedom with the
+            // current one as taken
+            colorTaken.assign(elementColors_.size(), false);
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                unsigned globalIdx = stencil.globalSpaceIndex(dofIdx);
+                const auto& colors = dofColors[globalIdx];
+                for (unsigned i = 0; i < colors.size(); ++i)
+                    colorTaken[colors[i]] = true;
+            }
+
+            // use the first color which is not taken. if there is none, create a new
+            // color.
+            unsigned color = 0;
+            while (color < colorTaken.size() && colorTaken[color])
+                ++color;
+            if (color == elementColors_.size())
+                elementColors_.resize(color + 1);
+
+            elementColors_[color].push_back(elemRow);
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx)
+                dofColors[stencil.globalSpaceIndex(dofIdx)].push_back(color);
         }
-        matrix_->endindices();
     }
 
     // reset the global linear system of equations.
     void resetSystem_()
     {
-        residual_ = 0.0;
-        (*matrix_) = 0.0;
+        parallelZero(residual_);
+        parallelZero(*matrix_);
     }
 
     // query the problem for all constraint degrees of freedom. note that this method is
@@ -347,42 +452,193 @@ private:
             // constraints are not explictly enabled, so we don't need to consider them!
             return;
 
-        unsigned threadId = ThreadManager::threadId();
-        constraintsMap_.clear();
+        constraintsMap_.clear(model_().numGridDof());
+        threadConstraints_.resize(ThreadManager::maxThreads());
 
-        // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        // loop over all elements. each thread collects the constraints of its elements
+        // separately.
+        elementScheduler_->rewind();
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                // create an element context (the solution-based quantities are not
-                // available here!)
-                const Element& elem = *elemIt;
-                ElementContext& elemCtx = *elementCtx_[threadId];
-                elemCtx.updateStencil(elem);
-
-                // check if the problem wants to constrain any degree of the current
-                // element's freedom. if yes, add the constraint to the map.
-                for (unsigned primaryDofIdx = 0;
-                     primaryDofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0);
-                     ++ primaryDofIdx)
-                {
-                    Constraints constraints;
-                    elemCtx.problem().constraints(constraints,
-                                                  elemCtx,
-                                                  primaryDofIdx,
-                                                  /*timeIdx=*/0);
-                    if (constraints.isActive()) {
-                        unsigned globI = elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
-                        constraintsMap_[globI] = constraints;
-                        continue;
+            // Attention: the variables below are thread specific and thus cannot be
+            // moved in front of the #pragma!
+            unsigned threadId = ThreadManager::threadId();
+            auto& threadConstraints = threadConstraints_[threadId];
+            threadConstraints.clear();
+
+            // create an element context (the solution-based quantities are not
+            // available here!)
+            ElementContext& elemCtx = *elementCtx_[threadId];
+            const auto& grid = gridView_().grid();
+
+            size_t beginIdx, endIdx;
+            while (elementScheduler_->nextRange(beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                    const Element elem = grid.entity(elementScheduler_->seed(elemIdx));
+#else
+                    const auto elemPtr = grid.entityPointer(elementScheduler_->seed(elemIdx));
+                    const Element& elem = *elemPtr;
+#endif
+                    elemCtx.setElementRow(static_cast<unsigned>(elemIdx));
+                    elemCtx.updateStencil(elem);
+
+                    // check if the problem wants to constrain any degree of the current
+                    // element's freedom. if yes, add the constraint to the map.
+                    for (unsigned primaryDofIdx = 0;
+                         primaryDofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0);
+                         ++ primaryDofIdx)
+                    {
+                        ElementConstraints_ elemConstraints;
+                        elemCtx.problem().constraints(elemConstraints.entry.second,
+                                                      elemCtx,
+                                                      primaryDofIdx,
+                                                      /*timeIdx=*/0);
+                        if (elemConstraints.entry.second.isActive()) {
+                            elemConstraints.elemRow = static_cast<unsigned>(elemIdx);
+                            elemConstraints.entry.first =
+                                elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
+                            threadConstraints.push_back(elemConstraints);
+                        }
                     }
                 }
             }
         }
+
+        // merge the constraints of all threads. if a degree of freedom is constrained by
+        // multiple elements, the last of them in the iteration order of the grid view
+        // wins, independently of how the elements were distributed to the threads.
+        auto& allConstraints = threadConstraints_[0];
+        for (unsigned threadId = 1; threadId < threadConstraints_.size(); ++threadId)
+            allConstraints.insert(allConstraints.end(),
+                                  threadConstraints_[threadId].begin(),
+                                  threadConstraints_[threadId].end());
+        std::sort(allConstraints.begin(), allConstraints.end(),
+                  [](const ElementConstraints_& a, const ElementConstraints_& b)
+                  {
+                      if (a.entry.first != b.entry.first)
+                          return a.entry.first < b.entry.first;
+                      return a.elemRow > b.elemRow;
+                  });
+
+        constraintsEntries_.clear();
+        for (const auto& elemConstraints : allConstraints)
+            if (constraintsEntries_.empty()
+                || constraintsEntries_.back().first != elemConstraints.entry.first)
+                constraintsEntries_.push_back(elemConstraints.entry);
+        constraintsMap_.insert(constraintsEntries_);
+    }
+
+    // record the addresses of the blocks of the Jacobian matrix which are touched by
+    // each element. the blocks of an element are stored in the same order as they are
+    // visited by linearizeElement_(), i.e., (primary DOF, DOF) pairs in lexicographic
+    // order.
+    void updateScatterMap_()
+    {
+        scatterMapOffsets_.clear();
+        scatterMap_.clear();
+
+        if (!useScatterMap_)
+            return;
+
+        scatterMapGridSequenceNumber_ = simulator_().gridManager().gridSequenceNumber();
+
+        // count the number of blocks of each element. the count of the element with
+        // index i is stored at position i + 1 so that the prefix sum can be computed in
+        // place.
+        size_t numElements = elementMapper_().size();
+        scatterMapOffsets_.assign(numElements + 1, 0);
+        forEachElementStencil_([this](const Element& elem, const Stencil& stencil) {
+            unsigned elemIdx = elementIndex_(elem);
+            scatterMapOffsets_[elemIdx + 1] = stencil.numPrimaryDof()*stencil.numDof();
+        });
+
+        for (size_t elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            scatterMapOffsets_[elemIdx + 1] += scatterMapOffsets_[elemIdx];
+        scatterMap_.resize(scatterMapOffsets_[numElements]);
+
+        // look up the addresses of the blocks. since each element only writes to its
+        // own part of the scatter map, no locking is required.
+        forEachElementStencil_([this](const Element& elem, const Stencil& stencil) {
+            unsigned elemIdx = elementIndex_(elem);
+            MatrixStorageBlock** blockPtr = scatterMap_.data() + scatterMapOffsets_[elemIdx];
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                unsigned globI = stencil.globalSpaceIndex(primaryDofIdx);
+                for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                    unsigned globJ = stencil.globalSpaceIndex(dofIdx);
+                    *blockPtr++ = &(*matrix_)[globJ][globI];
+                }
+            }
+        });
+    }
+
+    // call a functor for the topological stencil of each element of the grid
+    template <class Functor>
+    void forEachElementStencil_(const Functor& functor)
+    {
+        elementScheduler_->rewind();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Stencil stencil(gridView_(), model_().dofMapper());
+
+            elementScheduler_->run([&](const Element& elem) {
+                stencil.updateTopology(elem);
+                functor(elem, stencil);
+            });
+        }
+    }
+
+    unsigned elementIndex_(const Element& elem) const
+    {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+        return static_cast<unsigned>(elementMapper_().index(elem));
+#else
+        return static_cast<unsigned>(elementMapper_().map(elem));
+#endif
+    }
+
+    // call a functor and make sure that it succeeded on all processes
+    template <class Functor>
+    void runOnAllProcesses_(const Functor& functor)
+    {
+        int succeeded;
+        try {
+            functor();
+            succeeded = 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing:" << e.what()
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2, 5)
+        catch (const Dune::Exception& e)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing:" << e.what()
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+#endif
+        catch (...)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing"
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+        succeeded = gridView_().comm().min(succeeded);
+
+        if (!succeeded) {
+            OPM_THROW(Opm::NumericalProblem,
+                       "A process did not succeed in linearizing the system");
+        }
     }
 
     // linearize the whole system
@@ -398,59 +654,214 @@ private:
 
         applyConstraintsToSolution_();
 
-        *matrix_ = 0.0;
+        // evaluate the intensive quantities of all degrees of freedom in advance (if
+        // enabled)
+        model_().prefillIntensiveQuantityCache(/*timeIdx=*/0);
+
+        // evaluate the storage term of the previous time level (if it is cached and
+        // has not been evaluated for the current time step yet)
+        model_().updateStorageCache();
 
         // relinearize the elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        if (useColoredLinearization_)
+            linearizeColoredElements_();
+        else
+            linearizeElements_();
+
+        applyConstraintsToLinearization_();
+
+        linearizeAuxiliaryEquations_();
+    }
+
+    // evaluate the residual of the whole system
+    void linearizeResidual_()
+    {
+        parallelZero(residual_);
+
+        if (model_().newtonMethod().numIterations() == 0)
+            updateConstraintsMap_();
+
+        applyConstraintsToSolution_();
+
+        model_().prefillIntensiveQuantityCache(/*timeIdx=*/0);
+        model_().updateStorageCache();
+
+        // evaluate the local residuals of all elements. in contrast to
+        // linearizeElement_(), the local residual is only evaluated once per element
+        // because the focus degree of freedom does not matter for its value.
+        const bool useLock = GET_PROP_VALUE(TypeTag, UseLinearizationLock);
+        elementScheduler_->rewind();
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            ElementIterator nextElemIt = elemIt;
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = nextElemIt) {
-                // give the model and the problem a chance to prefetch the data required
-                // to linearize the next element, but only if we need to consider it
-                nextElemIt = threadedElemIt.increment();
-                if (!threadedElemIt.isFinished(nextElemIt)) {
-                    const auto& nextElem = *nextElemIt;
-                    if (linearizeNonLocalElements
-                        || nextElem.partitionType() == Dune::InteriorEntity)
-                    {
-                        model_().prefetch(nextElem);
-                        problem_().prefetch(nextElem);
-                    }
-                }
+            unsigned threadId = ThreadManager::threadId();
+            ElementContext& elemCtx = *elementCtx_[threadId];
+            auto& localResidual = model_().localResidual(threadId);
 
-                const Element& elem = *elemIt;
+            elementScheduler_->run([&](const Element& elem) {
                 if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+                    return;
+
+                elemCtx.updateAll(elem);
+                localResidual.eval(elemCtx);
+                const auto& localResid = localResidual.residual();
+
+                if (useLock)
+                    globalMatrixMutex_.lock();
+
+                size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+                for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
+                    unsigned globI = elemCtx.globalSpaceIndex(/*spaceIdx=*/primaryDofIdx, /*timeIdx=*/0);
+                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                        residual_[globI][eqIdx] += Toolbox::value(localResid[primaryDofIdx][eqIdx]);
+                }
+
+                if (useLock)
+                    globalMatrixMutex_.unlock();
+            });
+        }
+
+        // make the right-hand side of constraint DOFs zero
+        if (enableConstraints_()) {
+            auto it = constraintsMap_.begin();
+            const auto& endIt = constraintsMap_.end();
+            for (; it != endIt; ++it)
+                residual_[it->first] = 0.0;
+        }
+
+        auto& model = model_();
+        for (unsigned auxModIdx = 0; auxModIdx < model.numAuxiliaryModules(); ++auxModIdx)
+            model.auxiliaryModule(auxModIdx)->linearizeResidual(residual_);
+    }
+
+    // linearize all elements of the grid. the elements are handed out to the threads in
+    // chunks.
+    void linearizeElements_()
+    {
+        elementScheduler_->rewind();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            const auto& grid = gridView_().grid();
+            size_t beginIdx, endIdx;
+            while (elementScheduler_->nextRange(beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    // give the model and the problem a chance to prefetch the data
+                    // required to linearize the next element of the chunk, but only if
+                    // we need to consider it
+                    if (elemIdx + 1 < endIdx) {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                        const Element nextElem = grid.entity(elementScheduler_->seed(elemIdx + 1));
+#else
+                        const auto nextElemPtr = grid.entityPointer(elementScheduler_->seed(elemIdx + 1));
+                        const Element& nextElem = *nextElemPtr;
+#endif
+                        if (linearizeNonLocalElements
+                            || nextElem.partitionType() == Dune::InteriorEntity)
+                        {
+                            model_().prefetch(nextElem);
+                            problem_().prefetch(nextElem);
+                        }
+                    }
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                    const Element elem = grid.entity(elementScheduler_->seed(elemIdx));
+#else
+                    const auto elemPtr = grid.entityPointer(elementScheduler_->seed(elemIdx));
+                    const Element& elem = *elemPtr;
+#endif
+                    if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                        continue;
 
-                linearizeElement_(elem);
+                    linearizeElement_(elem,
+                                      static_cast<unsigned>(elemIdx),
+                                      GET_PROP_VALUE(TypeTag, UseLinearizationLock));
+                }
             }
         }
+    }
 
-        applyConstraintsToLinearization_();
+    // linearize all elements of the grid color by color. since no two elements of the
+    // same color share a degree of freedom, no locking is required.
+    void linearizeColoredElements_()
+    {
+        const auto& grid = gridView_().grid();
+        for (unsigned colorIdx = 0; colorIdx < elementColors_.size(); ++colorIdx) {
+            const auto& colorRows = elementColors_[colorIdx];
+            int numColorElements = static_cast<int>(colorRows.size());
+            const int chunkSize = 32;
 
-        linearizeAuxiliaryEquations_();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, chunkSize)
+#endif
+            for (int i = 0; i < numColorElements; ++i) {
+                // give the model and the problem a chance to prefetch the data required
+                // to linearize the next element of the chunk
+                if (i + 1 < numColorElements && (i + 1) % chunkSize != 0) {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                    const Element nextElem = grid.entity(elementScheduler_->seed(colorRows[i + 1]));
+#else
+                    const auto nextElemPtr = grid.entityPointer(elementScheduler_->seed(colorRows[i + 1]));
+                    const Element& nextElem = *nextElemPtr;
+#endif
+                    model_().prefetch(nextElem);
+                    problem_().prefetch(nextElem);
+                }
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                const Element elem = grid.entity(elementScheduler_->seed(colorRows[i]));
+#else
+                const auto elemPtr = grid.entityPointer(elementScheduler_->seed(colorRows[i]));
+                const Element& elem = *elemPtr;
+#endif
+
+                linearizeElement_(elem, colorRows[i], /*useLock=*/false);
+            }
+        }
     }
 
-    // linearize an element in the interior of the process' grid partition
-    void linearizeElement_(const Element& elem)
+    // linearize an element in the interior of the process' grid partition. elemRow is
+    // the position of the element in the iteration order of the grid view.
+    void linearizeElement_(const Element& elem, unsigned elemRow, bool useLock)
     {
         unsigned threadId = ThreadManager::threadId();
 
         ElementContext *elementCtx = elementCtx_[threadId];
         auto& localLinearizer = model_().localLinearizer(threadId);
 
+        // this allows stencils which use precomputed data to skip mapping the element
+        elementCtx->setElementRow(elemRow);
+
         // the actual work of linearization is done by the local linearizer class
         localLinearizer.linearize(*elementCtx, elem);
 
         // update the right hand side and the Jacobian matrix
-        if (GET_PROP_VALUE(TypeTag, UseLinearizationLock))
+        if (useLock)
             globalMatrixMutex_.lock();
 
         size_t numPrimaryDof = elementCtx->numPrimaryDof(/*timeIdx=*/0);
+        if (useScatterMap_) {
+            // write the Jacobian directly to the precomputed matrix blocks
+            size_t numDof = elementCtx->numDof(/*timeIdx=*/0);
+            unsigned elemIdx = elementIndex_(elem);
+            MatrixStorageBlock* const* blockPtr = scatterMap_.data() + scatterMapOffsets_[elemIdx];
+            assert(scatterMapOffsets_[elemIdx + 1] - scatterMapOffsets_[elemIdx] == numPrimaryDof*numDof);
+
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
+                unsigned globI = elementCtx->globalSpaceIndex(/*spaceIdx=*/primaryDofIdx, /*timeIdx=*/0);
+                residual_[globI] += localLinearizer.residual(primaryDofIdx);
+
+                for (unsigned dofIdx = 0; dofIdx < numDof; ++ dofIdx)
+                    **blockPtr++ += localLinearizer.jacobian(dofIdx, primaryDofIdx);
+            }
+
+            if (useLock)
+                globalMatrixMutex_.unlock();
+            return;
+        }
+
         for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
             unsigned globI = elementCtx->globalSpaceIndex(/*spaceIdx=*/primaryDofIdx, /*timeIdx=*/0);
 
@@ -465,7 +876,7 @@ private:
             }
         }
 
-        if (GET_PROP_VALUE(TypeTag, UseLinearizationLock))
+        if (useLock)
             globalMatrixMutex_.unlock();
     }
 
@@ -531,15 +942,41 @@ private:
     Simulator *simulatorPtr_;
     std::vector<ElementContext*> elementCtx_;
 
+    // distributes the elements to the threads
+    std::unique_ptr<ElementScheduler> elementScheduler_;
+
     // The constraint equations (only non-empty if the
     // EnableConstraints property is true)
-    std::map<unsigned, Constraints> constraintsMap_;
+    ConstraintsMap constraintsMap_;
+    // the constraints which are found by each thread
+    struct ElementConstraints_
+    {
+        // the position of the constraining element in the iteration order of the grid
+        // view
+        unsigned elemRow;
+        typename ConstraintsMap::value_type entry;
+    };
+    std::vector<std::vector<ElementConstraints_> > threadConstraints_;
+    // the merged constraints with a single entry per degree of freedom
+    std::vector<typename ConstraintsMap::value_type> constraintsEntries_;
 
     // the jacobian matrix
     Matrix *matrix_;
     // the right-hand side
     GlobalEqVector residual_;
 
+    // the elements of each color given by their position in the iteration order of the
+    // grid view (only non-empty if colored linearization is used)
+    bool useColoredLinearization_;
+    std::vector<std::vector<unsigned> > elementColors_;
+
+    // the addresses of the matrix blocks touched by each element (only non-empty if the
+    // scatter map is enabled). the blocks of the element with index i are located in
+    // the range [scatterMapOffsets_[i], scatterMapOffsets_[i + 1]).
+    bool useScatterMap_;
+    int scatterMapGridSequenceNumber_;
+    std::vector<size_t> scatterMapOffsets_;
+    std::vector<MatrixStorageBlock*> scatterMap_;
 
     OmpMutex globalMatrixMutex_;
 };
@@ -252,12 +252,18 @@ public:
             // for all previous solutions, the storage term does _not_ depend on the
             // current primary variables, so we use scalars to store it.
             if (elemCtx.enableStorageCache()) {
-                size_t numPrimaryDof = elemCtx.numPrimaryDof(timeIdx);
+                // the cached storage term is specified per volume unit. like for the
+                // residual, the volume of the current solution is used because the
+                // intensive quantities of the previous one are not available.
+                size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
                 for (unsigned dofIdx=0; dofIdx < numPrimaryDof; dofIdx++) {
-                    unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, timeIdx);
+                    unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
                     const auto& cachedStorage = elemCtx.model().cachedStorage(globalDofIdx, timeIdx);
+                    Scalar alpha =
+                        elemCtx.stencil(/*timeIdx=*/0).subControlVolume(dofIdx).volume()
+                        * elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0).extrusionFactor();
                     for (unsigned eqIdx=0; eqIdx < numEq; eqIdx++)
-                        storage[dofIdx][eqIdx] = cachedStorage[eqIdx];
+                        storage[dofIdx][eqIdx] = cachedStorage[eqIdx]*alpha;
                 }
             }
             else {
@@ -504,29 +510,11 @@ protected:
             Opm::Valgrind::CheckDefined(tmp);
 
             if (elemCtx.enableStorageCache()) {
-                const auto& model = elemCtx.model();
+                // if the storage term is cached, it has been evaluated for the solution
+                // at the beginning of the time step by the model
                 unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-                if (model.newtonMethod().numIterations() == 0 &&
-                    !elemCtx.haveStashedIntensiveQuantities())
-                {
-                    // if the storage term is cached and we're in the first iteration of
-                    // the time step, update the cache of the storage term (this assumes
-                    // that the initial guess for the solution at the end of the time
-                    // step is the same as the solution at the beginning of the time
-                    // step. This is usually true, but some fancy preprocessing scheme
-                    // might invalidate that assumption.)
-                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                        tmp2[eqIdx] = Toolbox::value(tmp[eqIdx]);
-                    Opm::Valgrind::CheckDefined(tmp2);
-
-                    model.updateCachedStorage(globalDofIdx, /*timeIdx=*/1, tmp2);
-                }
-                else {
-                    // if the storage term is cached and we're not looking at the first
-                    // iteration of the time step, we take the cached data.
-                    tmp2 = model.cachedStorage(globalDofIdx, /*timeIdx=*/1);
-                    Opm::Valgrind::CheckDefined(tmp2);
-                }
+                tmp2 = elemCtx.model().cachedStorage(globalDofIdx, /*timeIdx=*/1);
+                Opm::Valgrind::CheckDefined(tmp2);
             }
             else {
                 // if the mass storage at the beginning of the time step is not cached,
@@ -33,6 +33,10 @@
 #include <ewoms/nonlinear/newtonmethod.hh>
 #include <ewoms/common/propertysystem.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace Ewoms {
 
 template <class TypeTag>
@@ -66,6 +70,10 @@ NEW_PROP_TAG(DiscNewtonMethod);
 //! The class implementing the Newton algorithm
 NEW_PROP_TAG(NewtonMethod);
 
+//! The accumulated weighted change of the primary variables of a degree of freedom
+//! below which its cached intensive quantities are not recalculated
+NEW_PROP_TAG(NewtonIntensiveQuantitiesTolerance);
+
 // set default values
 SET_TYPE_PROP(FvBaseNewtonMethod, DiscNewtonMethod,
               Ewoms::FvBaseNewtonMethod<TypeTag>);
@@ -73,6 +81,10 @@ SET_TYPE_PROP(FvBaseNewtonMethod, NewtonMethod,
               typename GET_PROP_TYPE(TypeTag, DiscNewtonMethod));
 SET_TYPE_PROP(FvBaseNewtonMethod, NewtonConvergenceWriter,
               Ewoms::FvBaseNewtonConvergenceWriter<TypeTag>);
+
+// by default, the intensive quantities of all degrees of freedom are recalculated after
+// each Newton update
+SET_SCALAR_PROP(FvBaseNewtonMethod, NewtonIntensiveQuantitiesTolerance, 0.0);
 } // namespace Properties
 
 /*!
@@ -99,12 +111,27 @@ class FvBaseNewtonMethod : public NewtonMethod<TypeTag>
     typedef typename GET_PROP_TYPE(TypeTag, PrimaryVariables) PrimaryVariables;
     typedef typename GET_PROP_TYPE(TypeTag, EqVector) EqVector;
 
+    enum { numEq = GET_PROP_VALUE(TypeTag, NumEq) };
 
 public:
     FvBaseNewtonMethod(Simulator& simulator)
         : ParentType(simulator)
     { }
 
+    /*!
+     * \brief Register all run-time parameters for the Newton method.
+     */
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonIntensiveQuantitiesTolerance,
+                             "The accumulated weighted change of the primary variables of "
+                             "a degree of freedom below which its cached intensive "
+                             "quantities are kept by the Newton method (0 means that they "
+                             "are always recalculated)");
+    }
+
 protected:
     friend class Ewoms::NewtonMethod<TypeTag>;
 
@@ -132,14 +159,106 @@ protected:
     {
         ParentType::update_(nextSolution, currentSolution, solutionUpdate, currentResidual);
 
-        // make sure that the intensive quantities get recalculated at the next
-        // linearization
-        if (model_().storeIntensiveQuantities()) {
-            for (unsigned dofIdx = 0; dofIdx < model_().numGridDof(); ++dofIdx)
+        if (!model_().storeIntensiveQuantities())
+            return;
+
+        unsigned numGridDof = static_cast<unsigned>(model_().numGridDof());
+        Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonIntensiveQuantitiesTolerance);
+        if (tolerance <= 0.0) {
+            // make sure that the intensive quantities get recalculated at the next
+            // linearization
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int dofIdx = 0; dofIdx < static_cast<int>(numGridDof); ++dofIdx)
+                model_().setIntensiveQuantitiesCacheEntryValidity(static_cast<unsigned>(dofIdx),
+                                                                  /*timeIdx=*/0,
+                                                                  /*valid=*/false);
+            return;
+        }
+
+        // only recalculate the intensive quantities of the degrees of freedom whose
+        // primary variables changed significantly since their intensive quantities were
+        // calculated. the change is accumulated over the iterations so that the error
+        // of the cached quantities stays bounded.
+        if (intQuantsDeviation_.size() != numGridDof)
+            intQuantsDeviation_.assign(numGridDof, 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(numGridDof); ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            Scalar& deviation = intQuantsDeviation_[dofIdx];
+            deviation += asImp_().primaryVariablesChange_(dofIdx,
+                                                          nextSolution[dofIdx],
+                                                          currentSolution[dofIdx]);
+            if (deviation > tolerance) {
                 model_().setIntensiveQuantitiesCacheEntryValidity(dofIdx,
                                                                   /*timeIdx=*/0,
                                                                   /*valid=*/false);
+                deviation = 0.0;
+            }
+        }
+    }
+
+    /*!
+     * \brief Returns a measure of how much the primary variables of a degree of
+     *        freedom were changed by a Newton update.
+     *
+     * This is used to decide whether the intensive quantities of the degree of freedom
+     * need to be recalculated. By default, the largest weighted change of any primary
+     * variable is returned. Models where the meaning of the primary variables can
+     * change must return infinity if this happens.
+     */
+    Scalar primaryVariablesChange_(unsigned globalDofIdx,
+                                   const PrimaryVariables& nextValue,
+                                   const PrimaryVariables& currentValue) const
+    {
+        Scalar result = 0.0;
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+            Scalar delta = std::abs(nextValue[pvIdx] - currentValue[pvIdx]);
+            result = std::max(result, delta*model_().primaryVarWeight(globalDofIdx, pvIdx));
         }
+        return result;
+    }
+
+    /*!
+     * \copydoc NewtonMethod::failed_
+     */
+    void failed_()
+    {
+        // the cached intensive quantities of the previous time step will be used as the
+        // ones for the current solution, but their deviation from it is not known
+        // anymore. make sure that they get recalculated as soon as anything changes.
+        Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonIntensiveQuantitiesTolerance);
+        std::fill(intQuantsDeviation_.begin(), intQuantsDeviation_.end(), tolerance);
+
+        ParentType::failed_();
+    }
+
+    /*!
+     * \copydoc NewtonMethod::stepLengthRejected_
+     */
+    void stepLengthRejected_()
+    {
+        // the cached intensive quantities may correspond to the rejected update. since
+        // the update is only scaled, they get recalculated as soon as the primary
+        // variables are changed.
+        Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonIntensiveQuantitiesTolerance);
+        std::fill(intQuantsDeviation_.begin(), intQuantsDeviation_.end(), tolerance);
+
+        ParentType::stepLengthRejected_();
+    }
+
+    /*!
+     * \copydoc NewtonMethod::prepareTrialSolution_
+     */
+    void prepareTrialSolution_()
+    {
+        model_().syncOverlap();
+
+        ParentType::prepareTrialSolution_();
     }
 
     /*!
@@ -170,6 +289,10 @@ private:
 
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
+
+    // the accumulated change of the primary variables of each degree of freedom since
+    // its cached intensive quantities were calculated
+    std::vector<Scalar> intQuantsDeviation_;
 };
 } // namespace Ewoms
 
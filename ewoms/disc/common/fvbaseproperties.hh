@@ -168,6 +168,27 @@ NEW_PROP_TAG(ThreadsPerProcess);
 //! discretizations do not need this.)
 NEW_PROP_TAG(UseLinearizationLock);
 
+/*!
+ * \brief Specify whether the elements should be colored for linearization
+ *
+ * If this is enabled, the elements of the grid are partitioned into "colors" such that
+ * the elements of a given color do not share any degree of freedom. The elements of a
+ * color can thus be linearized concurrently without having to lock the global linear
+ * system of equations. This only has an effect if the UseLinearizationLock property is
+ * true.
+ */
+NEW_PROP_TAG(EnableColoredLinearization);
+
+/*!
+ * \brief Specify whether the addresses of the matrix blocks touched by each element
+ *        should be precomputed.
+ *
+ * If this is enabled, the blocks of the Jacobian matrix are directly addressed during
+ * linearization instead of searching for them in the rows of the sparse matrix. This
+ * costs some memory for each element.
+ */
+NEW_PROP_TAG(EnableJacobianScatterMap);
+
 // high-level simulation control
 
 //! Manages the simulation time
@@ -252,6 +273,50 @@ NEW_PROP_TAG(EnableStorageCache);
  */
 NEW_PROP_TAG(EnableThermodynamicHints);
 
+/*!
+ * \brief Specify whether the intensive quantity cache should be filled for all degrees
+ *        of freedom before the system of equations is linearized.
+ *
+ * This only has an effect if the intensive quantity cache is enabled.
+ */
+NEW_PROP_TAG(PrefillIntensiveQuantityCache);
+
+/*!
+ * \brief The class which stores the intensive quantities of all degrees of freedom
+ *        field by field.
+ */
+NEW_PROP_TAG(IntensiveQuantitiesFieldStorage);
+
+/*!
+ * \brief Specify whether the intensive quantity cache should store the intensive
+ *        quantities field by field instead of as an array of objects.
+ *
+ * This only has an effect if the intensive quantity cache is enabled, and it is only
+ * supported by some models.
+ */
+NEW_PROP_TAG(EnableIntensiveQuantityFieldStorage);
+
+/*!
+ * \brief Specify whether the derivatives are stored using single precision if the
+ *        intensive quantities are stored field by field.
+ */
+NEW_PROP_TAG(IntensiveQuantityFieldStorageSinglePrecision);
+
+/*!
+ * \brief Specify whether the memory used by the intensive quantity cache is printed
+ *        when the simulation is initialized.
+ */
+NEW_PROP_TAG(PrintIntensiveQuantityCacheMemoryUsage);
+
+/*!
+ * \brief The order of the polynomial which is used to extrapolate the solutions of the
+ *        previous time steps to the initial guess of the Newton method.
+ *
+ * 0 means that the solution of the last time step is used as is, 1 and 2 specify linear
+ * and quadratic extrapolation.
+ */
+NEW_PROP_TAG(PredictorOrder);
+
 // mappers from local to global DOF indices
 
 /*!
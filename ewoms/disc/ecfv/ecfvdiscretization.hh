@@ -32,6 +32,7 @@
 
 #include "ecfvproperties.hh"
 #include "ecfvstencil.hh"
+#include "ecfvelementcontext.hh"
 #include "ecfvgridcommhandlefactory.hh"
 #include "ecfvbaseoutputmodule.hh"
 
@@ -61,6 +62,12 @@ public:
     typedef Ewoms::EcfvStencil<Scalar, GridView> type;
 };
 
+//! Use the element context which is able to use precomputed stencils
+SET_TYPE_PROP(EcfvDiscretization, ElementContext, Ewoms::EcfvElementContext<TypeTag>);
+
+//! By default, the stencils are recomputed each time they are needed
+SET_BOOL_PROP(EcfvDiscretization, EnableConnectivityCache, false);
+
 //! Mapper for the degrees of freedoms.
 SET_TYPE_PROP(EcfvDiscretization, DofMapper, typename GET_PROP_TYPE(TypeTag, ElementMapper));
 
@@ -132,11 +139,60 @@ class EcfvDiscretization : public FvBaseDiscretization<TypeTag>
     typedef typename GET_PROP_TYPE(TypeTag, SolutionVector) SolutionVector;
     typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
     typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, Stencil) Stencil;
 
 public:
+    typedef typename Stencil::Connectivity Connectivity;
+
     EcfvDiscretization(Simulator& simulator)
         : ParentType(simulator)
-    { }
+    {
+        // the precomputed stencils would need to be updated after the element mapper
+        // when the grid is adapted. since adaptivity changes the grid anyway, simply
+        // do not use them in this case.
+        enableConnectivityCache_ =
+            EWOMS_GET_PARAM(TypeTag, bool, EnableConnectivityCache)
+            && !this->enableGridAdaptation();
+    }
+
+    /*!
+     * \brief Register all run-time parameters for the model.
+     */
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableConnectivityCache,
+                             "Compute the stencils of all elements once per grid instead of "
+                             "each time they are required");
+    }
+
+    /*!
+     * \brief Apply the initial conditions to the model.
+     */
+    void finishInit()
+    {
+        // the element contexts used by the parent class already need the precomputed
+        // stencils
+        if (enableConnectivityCache_)
+            connectivity_.update(this->gridView_, asImp_().dofMapper());
+
+        ParentType::finishInit();
+    }
+
+    /*!
+     * \brief Returns true iff the stencils of the elements are precomputed.
+     */
+    bool enableConnectivityCache() const
+    { return enableConnectivityCache_; }
+
+    /*!
+     * \brief Returns the precomputed stencils of all elements of the grid view.
+     *
+     * This object is only populated if enableConnectivityCache() is true.
+     */
+    const Connectivity& connectivity() const
+    { return connectivity_; }
 
     /*!
      * \brief Returns a string of discretization's human-readable name
@@ -211,6 +267,9 @@ private:
     { return *static_cast<Implementation*>(this); }
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
+
+    bool enableConnectivityCache_;
+    Connectivity connectivity_;
 };
 } // namespace Ewoms
 
@@ -0,0 +1,71 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::EcfvElementContext
+ */
+#ifndef EWOMS_ECFV_ELEMENT_CONTEXT_HH
+#define EWOMS_ECFV_ELEMENT_CONTEXT_HH
+
+#include "ecfvproperties.hh"
+
+#include <ewoms/disc/common/fvbaseelementcontext.hh>
+
+namespace Ewoms {
+
+/*!
+ * \ingroup EcfvDiscretization
+ *
+ * \brief The element context of the element-centered finite-volume discretization.
+ *
+ * If the model provides precomputed stencils (see EcfvDiscretization::connectivity()),
+ * updating the stencil of an element only amounts to looking up the element's index.
+ * Everything else behaves exactly like FvBaseElementContext.
+ */
+template<class TypeTag>
+class EcfvElementContext : public FvBaseElementContext<TypeTag>
+{
+    typedef FvBaseElementContext<TypeTag> ParentType;
+
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+
+public:
+    explicit EcfvElementContext(const Simulator& simulator)
+        : ParentType(simulator)
+    {
+        const auto& model = simulator.model();
+        if (model.enableConnectivityCache())
+            this->stencil_.setConnectivity(&model.connectivity());
+    }
+
+    /*!
+     * \copydoc FvBaseElementContext::setElementRow()
+     */
+    void setElementRow(unsigned row)
+    { this->stencil_.setElementRow(row); }
+};
+
+} // namespace Ewoms
+
+#endif
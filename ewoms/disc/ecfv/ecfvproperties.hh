@@ -37,6 +37,10 @@ namespace Ewoms {
 namespace Properties {
 //! The type tag for models based on the ECFV-scheme
 NEW_TYPE_TAG(EcfvDiscretization, INHERITS_FROM(FvBaseDiscretization));
+
+//! Specify whether the stencils of all elements are computed once per grid instead of
+//! each time an element context is updated. This requires grid adaptation to be disabled.
+NEW_PROP_TAG(EnableConnectivityCache);
 }} // namespace Properties, Ewoms
 
 #endif
@@ -37,6 +37,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
 
+#include <cassert>
+#include <limits>
 #include <vector>
 
 namespace Ewoms {
@@ -61,6 +63,7 @@ class EcfvStencil
     typedef typename GridView::ctype CoordScalar;
     typedef typename GridView::Intersection Intersection;
     typedef typename GridView::template Codim<0>::Entity Element;
+    typedef typename Element::EntitySeed ElementSeed;
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
     typedef typename GridView::template Codim<0>::EntityPointer ElementPointer;
 #endif
@@ -122,6 +125,19 @@ public:
             volume_ = geometry.volume();
         }
 
+        /*!
+         * \brief Set the center and the volume of the sub-control volume without
+         *        evaluating the geometry of an element.
+         *
+         * This is used by stencils which use precomputed data. For such sub-control
+         * volumes, geometry() and element() are not available.
+         */
+        void update(const GlobalPosition& centerPos, Scalar volume)
+        {
+            centerPos_ = centerPos;
+            volume_ = volume;
+        }
+
         /*!
          * \brief The global position associated with the sub-control volume
          */
@@ -151,6 +167,17 @@ public:
         { return elementPtr_->geometry(); }
 #endif
 
+        /*!
+         * \brief The element which corresponds to the sub-control volume.
+         */
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+        const Element& element() const
+        { return element_; }
+#else
+        const Element& element() const
+        { return *elementPtr_; }
+#endif
+
     private:
         GlobalPosition centerPos_;
         Scalar volume_;
@@ -183,6 +210,10 @@ public:
             if (needIntegrationPos)
                 (*integrationPos_) = geometry.center();
             area_ = geometry.volume();
+
+            boundarySegmentIdx_ = std::numeric_limits<unsigned>::max();
+            if (intersection.boundary())
+                boundarySegmentIdx_ = static_cast<unsigned>(intersection.boundarySegmentIndex());
         }
 
         /*!
@@ -226,23 +257,256 @@ public:
         Scalar area() const
         { return area_; }
 
+        /*!
+         * \brief Returns the index of the boundary segment of the grid which contains
+         *        the face.
+         *
+         * For faces which are not located on the boundary of the domain, the largest
+         * representable number is returned.
+         */
+        unsigned boundarySegmentIndex() const
+        { return boundarySegmentIdx_; }
+
     private:
         ConditionalStorage<needIntegrationPos, GlobalPosition> integrationPos_;
         ConditionalStorage<needNormal, WorldVector> normal_;
         Scalar area_;
 
         unsigned short exteriorIdx_;
+        unsigned boundarySegmentIdx_;
     };
 
     typedef EcfvSubControlVolumeFace<needFaceIntegrationPos, needFaceNormal> SubControlVolumeFace;
 
+    /*!
+     * \brief The precomputed topology and geometry of the stencils of all elements of a
+     *        grid view.
+     *
+     * The centers and volumes of the elements, the neighbor indices and the faces of
+     * all elements are stored in flat arrays in compressed row storage format. The rows
+     * are ordered like the elements of the grid view, i.e., the row of an element is
+     * its position in the iteration order of the grid view. (This is the same order as
+     * the one used by ThreadedEntityScheduler.) A stencil which is attached to such an
+     * object using setConnectivity() only needs to determine the row of the element in
+     * update(): It does neither iterate over intersections, nor evaluate geometries,
+     * nor construct entity objects for the neighbors. If the row is specified using
+     * setElementRow(), not even the element mapper is used.
+     *
+     * The object must be updated whenever the grid is changed.
+     */
+    class Connectivity
+    {
+    public:
+        /*!
+         * \brief Compute the stencils of all elements of a grid view.
+         */
+        void update(const GridView& gridView, const Mapper& mapper)
+        {
+            size_t numElements = static_cast<size_t>(gridView.size(/*codim=*/0));
+
+            rowIdx_.assign(numElements, 0);
+            elementIndices_.clear();
+            elementIndices_.reserve(numElements);
+            elementSeeds_.clear();
+            elementSeeds_.reserve(numElements);
+            partitionTypes_.clear();
+            partitionTypes_.reserve(numElements);
+            centers_.clear();
+            centers_.reserve(numElements);
+            volumes_.clear();
+            volumes_.reserve(numElements);
+            neighborOffsets_.assign(1, 0);
+            neighborOffsets_.reserve(numElements + 1);
+            boundaryFaceOffsets_.assign(1, 0);
+            boundaryFaceOffsets_.reserve(numElements + 1);
+            neighborIndices_.clear();
+            interiorFaces_.clear();
+            boundaryFaces_.clear();
+
+            // the stencil which is used to compute the data is not attached to any
+            // connectivity object, i.e., it walks the intersections of each element.
+            EcfvStencil stencil(gridView, mapper);
+            auto elemIt = gridView.template begin</*codim=*/0>();
+            const auto& elemEndIt = gridView.template end</*codim=*/0>();
+            for (; elemIt != elemEndIt; ++elemIt) {
+                const Element& elem = *elemIt;
+                stencil.updateTopology(elem);
+
+                unsigned elemIdx = stencil.globalSpaceIndex(/*dofIdx=*/0);
+                rowIdx_[elemIdx] = static_cast<unsigned>(elementIndices_.size());
+                elementIndices_.push_back(elemIdx);
+                elementSeeds_.push_back(elem.seed());
+                partitionTypes_.push_back(elem.partitionType());
+
+                const auto& scv = stencil.subControlVolume(/*dofIdx=*/0);
+                centers_.push_back(scv.center());
+                volumes_.push_back(scv.volume());
+
+                // for the element centered finite volume method, each interior face
+                // corresponds to exactly one neighbor
+                assert(stencil.numInteriorFaces() == stencil.numDof() - 1);
+                for (unsigned faceIdx = 0; faceIdx < stencil.numInteriorFaces(); ++faceIdx) {
+                    const auto& face = stencil.interiorFace(faceIdx);
+                    neighborIndices_.push_back(stencil.globalSpaceIndex(face.exteriorIndex()));
+                    interiorFaces_.push_back(face);
+                }
+
+                for (unsigned faceIdx = 0; faceIdx < stencil.numBoundaryFaces(); ++faceIdx)
+                    boundaryFaces_.push_back(stencil.boundaryFace(faceIdx));
+
+                neighborOffsets_.push_back(neighborIndices_.size());
+                boundaryFaceOffsets_.push_back(boundaryFaces_.size());
+            }
+
+            // the rows of the neighbors are needed to access their sub-control volumes
+            neighborRows_.resize(neighborIndices_.size());
+            for (size_t i = 0; i < neighborIndices_.size(); ++i)
+                neighborRows_[i] = rowIdx_[neighborIndices_[i]];
+        }
+
+        /*!
+         * \brief Returns the number of elements of the grid view.
+         */
+        size_t numElements() const
+        { return rowIdx_.size(); }
+
+        /*!
+         * \brief Returns the row of an element given its index.
+         */
+        unsigned row(unsigned elemIdx) const
+        { return rowIdx_[elemIdx]; }
+
+        /*!
+         * \brief Returns the index of the element in a given row.
+         */
+        unsigned elementIndex(unsigned row) const
+        { return elementIndices_[row]; }
+
+        /*!
+         * \brief Returns the seed of the element in a given row.
+         */
+        const ElementSeed& elementSeed(unsigned row) const
+        { return elementSeeds_[row]; }
+
+        /*!
+         * \brief Returns the partition type of the element in a given row.
+         */
+        Dune::PartitionType partitionType(unsigned row) const
+        { return partitionTypes_[row]; }
+
+        /*!
+         * \brief Returns the center of the element in a given row.
+         */
+        const GlobalPosition& center(unsigned row) const
+        { return centers_[row]; }
+
+        /*!
+         * \brief Returns the volume of the element in a given row.
+         */
+        Scalar volume(unsigned row) const
+        { return volumes_[row]; }
+
+        /*!
+         * \brief Returns the number of neighbors of an element given its row.
+         */
+        size_t numNeighbors(unsigned row) const
+        { return neighborOffsets_[row + 1] - neighborOffsets_[row]; }
+
+        /*!
+         * \brief Returns the number of boundary faces of an element given its row.
+         */
+        size_t numBoundaryFaces(unsigned row) const
+        { return boundaryFaceOffsets_[row + 1] - boundaryFaceOffsets_[row]; }
+
+        /*!
+         * \brief Returns the element index of a neighbor of an element.
+         */
+        unsigned neighborIndex(unsigned row, unsigned neighborIdx) const
+        { return neighborIndices_[neighborOffsets_[row] + neighborIdx]; }
+
+        /*!
+         * \brief Returns the row of a neighbor of an element.
+         */
+        unsigned neighborRow(unsigned row, unsigned neighborIdx) const
+        { return neighborRows_[neighborOffsets_[row] + neighborIdx]; }
+
+        /*!
+         * \brief Returns an interior face of an element.
+         */
+        const SubControlVolumeFace& interiorFace(unsigned row, unsigned faceIdx) const
+        { return interiorFaces_[neighborOffsets_[row] + faceIdx]; }
+
+        /*!
+         * \brief Returns a boundary face of an element.
+         */
+        const SubControlVolumeFace& boundaryFace(unsigned row, unsigned faceIdx) const
+        { return boundaryFaces_[boundaryFaceOffsets_[row] + faceIdx]; }
+
+    private:
+        std::vector<unsigned> rowIdx_;
+        std::vector<unsigned> elementIndices_;
+        std::vector<ElementSeed> elementSeeds_;
+        std::vector<Dune::PartitionType> partitionTypes_;
+        std::vector<GlobalPosition> centers_;
+        std::vector<Scalar> volumes_;
+
+        std::vector<size_t> neighborOffsets_;
+        std::vector<unsigned> neighborIndices_;
+        std::vector<unsigned> neighborRows_;
+        std::vector<SubControlVolumeFace> interiorFaces_;
+
+        std::vector<size_t> boundaryFaceOffsets_;
+        std::vector<SubControlVolumeFace> boundaryFaces_;
+    };
+
     EcfvStencil(const GridView& gridView, const Mapper& mapper)
         : gridView_(gridView)
         , elementMapper_(mapper)
+        , connectivity_(0)
+        , useConnectivity_(false)
+        , rowHint_(noRow_)
+        , centerElemPtr_(0)
+        , neighborElementsUpToDate_(false)
     { }
 
+    /*!
+     * \brief Use precomputed data for the stencils instead of recomputing it in each
+     *        call to update().
+     *
+     * The connectivity object must outlive the stencil and it must not be changed
+     * while it is attached. Whether it matches the grid view is only checked here.
+     * Passing a null pointer switches back to computing the stencil from the grid.
+     *
+     * The precomputed data is only used for DUNE 2.4 or newer.
+     */
+    void setConnectivity(const Connectivity* connectivity)
+    {
+        connectivity_ = connectivity;
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+        useConnectivity_ =
+            connectivity_
+            && connectivity_->numElements() == static_cast<size_t>(gridView_.size(/*codim=*/0));
+#else
+        useConnectivity_ = false;
+#endif
+    }
+
+    /*!
+     * \brief Specify the position of the element which is passed to the next update
+     *        in the iteration order of the grid view.
+     *
+     * If precomputed data is used, this avoids mapping the element to its index. The
+     * hint only applies to the next update of the stencil and it is ignored if no
+     * precomputed data is used.
+     */
+    void setElementRow(unsigned row)
+    { rowHint_ = row; }
+
     void updateTopology(const Element& element)
     {
+        if (updateFromConnectivity_(element))
+            return;
+
         auto isIt = gridView_.ibegin(element);
         const auto& endIsIt = gridView_.iend(element);
 
@@ -282,6 +546,9 @@ public:
 
     void updatePrimaryTopology(const Element& element)
     {
+        if (updateFromConnectivity_(element))
+            return;
+
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
         // add the "center" element of the stencil
         subControlVolumes_.clear();
@@ -326,7 +593,11 @@ public:
      *        current element interacts with.
      */
     size_t numDof() const
-    { return subControlVolumes_.size(); }
+    {
+        if (useConnectivity_)
+            return 1 + connectivity_->numNeighbors(centerRow_);
+        return subControlVolumes_.size();
+    }
 
     /*!
      * \brief Returns the number of degrees of freedom which are contained
@@ -348,6 +619,12 @@ public:
     {
         assert(0 <= dofIdx && dofIdx < numDof());
 
+        if (useConnectivity_) {
+            if (dofIdx == 0)
+                return centerIdx_;
+            return connectivity_->neighborIndex(centerRow_, dofIdx - 1);
+        }
+
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
         return static_cast<unsigned>(elementMapper_.index(element(dofIdx)));
 #else
@@ -359,7 +636,11 @@ public:
      * \brief Return partition type of a given degree of freedom
      */
     Dune::PartitionType partitionType(unsigned dofIdx) const
-    { return elements_[dofIdx]->partitionType(); }
+    {
+        if (useConnectivity_)
+            return connectivity_->partitionType(dofRow_(dofIdx));
+        return element(dofIdx).partitionType();
+    }
 
     /*!
      * \brief Return the element given the index of a degree of
@@ -372,6 +653,15 @@ public:
     {
         assert(0 <= dofIdx && dofIdx < numDof());
 
+        if (useConnectivity_) {
+            if (dofIdx == 0)
+                return *centerElemPtr_;
+
+            // the neighbor elements are only constructed if they are really needed
+            if (!neighborElementsUpToDate_)
+                updateNeighborElements_();
+        }
+
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
         return elements_[dofIdx];
 #else
@@ -399,41 +689,130 @@ public:
      * \brief Returns the number of interior faces of the stencil.
      */
     size_t numInteriorFaces() const
-    { return interiorFaces_.size(); }
+    {
+        if (useConnectivity_)
+            return connectivity_->numNeighbors(centerRow_);
+        return interiorFaces_.size();
+    }
 
     /*!
      * \brief Returns the face object belonging to a given face index
      *        in the interior of the domain.
      */
     const SubControlVolumeFace& interiorFace(unsigned bfIdx) const
-    { return interiorFaces_[bfIdx]; }
+    {
+        if (useConnectivity_)
+            return connectivity_->interiorFace(centerRow_, bfIdx);
+        return interiorFaces_[bfIdx];
+    }
 
     /*!
      * \brief Returns the number of boundary faces of the stencil.
      */
     size_t numBoundaryFaces() const
-    { return boundaryFaces_.size(); }
+    {
+        if (useConnectivity_)
+            return connectivity_->numBoundaryFaces(centerRow_);
+        return boundaryFaces_.size();
+    }
 
     /*!
      * \brief Returns the boundary face object belonging to a given
      *        boundary face index.
      */
     const SubControlVolumeFace& boundaryFace(unsigned bfIdx) const
-    { return boundaryFaces_[bfIdx]; }
+    {
+        if (useConnectivity_)
+            return connectivity_->boundaryFace(centerRow_, bfIdx);
+        return boundaryFaces_[bfIdx];
+    }
 
 protected:
+    static const unsigned noRow_ = std::numeric_limits<unsigned>::max();
+
+    // if a connectivity object is attached, only determine the element's row in it and
+    // copy the centers and volumes of the stencil's elements
+    bool updateFromConnectivity_(const Element& element)
+    {
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+        // sub-control volumes without an element can only be created for DUNE 2.4 or
+        // newer
+        return false;
+#else
+        if (!useConnectivity_) {
+            rowHint_ = noRow_;
+            return false;
+        }
+
+        if (rowHint_ != noRow_) {
+            centerRow_ = rowHint_;
+            centerIdx_ = connectivity_->elementIndex(centerRow_);
+            rowHint_ = noRow_;
+            assert(centerIdx_ == static_cast<unsigned>(elementMapper_.index(element)));
+        }
+        else {
+            centerIdx_ = static_cast<unsigned>(elementMapper_.index(element));
+            centerRow_ = connectivity_->row(centerIdx_);
+        }
+        centerElemPtr_ = &element;
+        neighborElementsUpToDate_ = false;
+
+        size_t n = numDof();
+        subControlVolumes_.resize(n);
+        for (unsigned dofIdx = 0; dofIdx < n; ++dofIdx) {
+            unsigned row = dofRow_(dofIdx);
+            subControlVolumes_[dofIdx].update(connectivity_->center(row),
+                                              connectivity_->volume(row));
+        }
+
+        return true;
+#endif
+    }
+
+    unsigned dofRow_(unsigned dofIdx) const
+    {
+        if (dofIdx == 0)
+            return centerRow_;
+        return connectivity_->neighborRow(centerRow_, dofIdx - 1);
+    }
+
+    void updateNeighborElements_() const
+    {
+        const auto& grid = gridView_.grid();
+        elements_.clear();
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+        elements_.push_back(*centerElemPtr_);
+        for (unsigned dofIdx = 1; dofIdx < numDof(); ++dofIdx)
+            elements_.push_back(grid.entity(connectivity_->elementSeed(dofRow_(dofIdx))));
+#else
+        elements_.push_back(ElementPointer(*centerElemPtr_));
+        for (unsigned dofIdx = 1; dofIdx < numDof(); ++dofIdx)
+            elements_.push_back(grid.entityPointer(connectivity_->elementSeed(dofRow_(dofIdx))));
+#endif
+        neighborElementsUpToDate_ = true;
+    }
+
     const GridView&       gridView_;
     const ElementMapper&  elementMapper_;
 
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
-    std::vector<Element> elements_;
+    mutable std::vector<Element> elements_;
 #else
-    std::vector<ElementPointer> elements_;
+    mutable std::vector<ElementPointer> elements_;
 #endif
 
     std::vector<SubControlVolume>      subControlVolumes_;
     std::vector<SubControlVolumeFace>  interiorFaces_;
     std::vector<SubControlVolumeFace>  boundaryFaces_;
+
+    // the precomputed stencils (if any) and the position of the current element in it
+    const Connectivity* connectivity_;
+    bool useConnectivity_;
+    unsigned rowHint_;
+    unsigned centerIdx_;
+    unsigned centerRow_;
+    const Element* centerElemPtr_;
+    mutable bool neighborElementsUpToDate_;
 };
 
 } // namespace Ewoms
@@ -110,6 +110,28 @@ public:
             const LocalFiniteElement& localFE = feCache_.get(elemCtx.element().type());
             localFiniteElement_ = &localFE;
 
+            // if the stencil provides the values and gradients of the shape functions,
+            // they do not need to be evaluated
+            if (stencil.numInteriorFaces() > 0 && stencil.cachedShapeValues(/*faceIdx=*/0)) {
+                size_t numVertices = elemCtx.numDof(timeIdx);
+                for (unsigned faceIdx = 0; faceIdx < stencil.numInteriorFaces(); ++faceIdx) {
+                    if (prepareValues) {
+                        const auto* values = stencil.cachedShapeValues(faceIdx);
+                        p1Value_[faceIdx].resize(numVertices);
+                        for (unsigned vertIdx = 0; vertIdx < numVertices; vertIdx++)
+                            p1Value_[faceIdx][vertIdx] = values[vertIdx];
+                    }
+
+                    if (prepareGradients) {
+                        const auto* gradients = stencil.cachedShapeGradients(faceIdx);
+                        for (unsigned vertIdx = 0; vertIdx < numVertices; vertIdx++)
+                            p1Gradient_[faceIdx][vertIdx] = gradients[vertIdx];
+                    }
+                }
+
+                return;
+            }
+
             // loop over all face centeres
             for (unsigned faceIdx = 0; faceIdx < stencil.numInteriorFaces(); ++faceIdx) {
                 const auto& localFacePos = stencil.interiorFace(faceIdx).localPos();
@@ -121,8 +143,7 @@ public:
 
                 if (prepareGradients) {
                     // first, get the shape function's gradient in local coordinates
-                    std::vector<ShapeJacobian> localGradient;
-                    localFE.localBasis().evaluateJacobian(localFacePos, localGradient);
+                    localFE.localBasis().evaluateJacobian(localFacePos, localGradient_);
 
                     // convert to a gradient in global space by
                     // multiplying with the inverse transposed jacobian of
@@ -133,7 +154,7 @@ public:
 
                     size_t numVertices = elemCtx.numDof(timeIdx);
                     for (unsigned vertIdx = 0; vertIdx < numVertices; vertIdx++) {
-                        jacInvT.mv(/*xVector=*/localGradient[vertIdx][0],
+                        jacInvT.mv(/*xVector=*/localGradient_[vertIdx][0],
                                    /*destVector=*/p1Gradient_[faceIdx][vertIdx]);
                     }
                 }
@@ -350,6 +371,9 @@ private:
     const LocalFiniteElement* localFiniteElement_;
     std::vector<Dune::FieldVector<Scalar, 1>> p1Value_[maxFap];
     DimVector p1Gradient_[maxFap][maxDof];
+
+    // the memory of this vector is reused for all elements
+    std::vector<ShapeJacobian> localGradient_;
 #endif // HAVE_DUNE_LOCALFUNCTIONS
 };
 
@@ -32,6 +32,7 @@
 
 #include "vcfvproperties.hh"
 #include "vcfvstencil.hh"
+#include "vcfvelementcontext.hh"
 #include "p1fegradientcalculator.hh"
 #include "vcfvgridcommhandlefactory.hh"
 #include "vcfvbaseoutputmodule.hh"
@@ -39,6 +40,8 @@
 #include <ewoms/linear/vertexborderlistfromgrid.hh>
 #include <ewoms/disc/common/fvbasediscretization.hh>
 
+#include <iostream>
+
 #if HAVE_DUNE_FEM
 #include <dune/fem/space/common/functionspace.hh>
 #include <dune/fem/space/lagrange.hh>
@@ -60,6 +63,12 @@ public:
     typedef Ewoms::VcfvStencil<CoordScalar, GridView> type;
 };
 
+//! Use the element context which is able to use the cached geometry of the stencils
+SET_TYPE_PROP(VcfvDiscretization, ElementContext, Ewoms::VcfvElementContext<TypeTag>);
+
+//! By default, the geometry of the stencils is recomputed each time it is needed
+SET_BOOL_PROP(VcfvDiscretization, EnableGeometryCache, false);
+
 //! Mapper for the degrees of freedoms.
 SET_TYPE_PROP(VcfvDiscretization, DofMapper, typename GET_PROP_TYPE(TypeTag, VertexMapper));
 
@@ -129,13 +138,68 @@ class VcfvDiscretization : public FvBaseDiscretization<TypeTag>
     typedef typename GET_PROP_TYPE(TypeTag, DofMapper) DofMapper;
     typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
     typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, Stencil) Stencil;
 
     enum { dim = GridView::dimension };
 
 public:
+    typedef typename Stencil::GeometryCache GeometryCache;
+
     VcfvDiscretization(Simulator& simulator)
         : ParentType(simulator)
-    { }
+    {
+        enableGeometryCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableGeometryCache);
+    }
+
+    /*!
+     * \brief Register all run-time parameters for the model.
+     */
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableGeometryCache,
+                             "Compute the geometry of the stencils of all elements once per grid "
+                             "instead of each time it is required");
+    }
+
+    /*!
+     * \brief Apply the initial conditions to the model.
+     */
+    void finishInit()
+    {
+        // the element contexts used by the parent class already use the cached geometry
+        if (enableGeometryCache_) {
+            geometryCache_.update(this->gridView_,
+                                  asImp_().dofMapper(),
+                                  this->elementMapper(),
+                                  GET_PROP_VALUE(TypeTag, UseP1FiniteElementGradients));
+
+            // report the memory required by the cache to be able to decide whether it
+            // is worth it
+            double memoryUsage = static_cast<double>(geometryCache_.memoryUsage());
+            memoryUsage = this->gridView_.comm().sum(memoryUsage);
+            if (this->gridView_.comm().rank() == 0)
+                std::cout << "The geometry cache of the stencils uses "
+                          << memoryUsage/(1024*1024) << " MiB\n" << std::flush;
+        }
+
+        ParentType::finishInit();
+    }
+
+    /*!
+     * \brief Returns true iff the geometry of the stencils is cached.
+     */
+    bool enableGeometryCache() const
+    { return enableGeometryCache_; }
+
+    /*!
+     * \brief Returns the cached geometry of the stencils of all elements.
+     *
+     * This object is only populated if enableGeometryCache() is true.
+     */
+    const GeometryCache& geometryCache() const
+    { return geometryCache_; }
 
     /*!
      * \brief Returns a string of discretization's human-readable name
@@ -186,6 +250,9 @@ private:
     { return *static_cast<Implementation*>(this); }
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
+
+    bool enableGeometryCache_;
+    GeometryCache geometryCache_;
 };
 } // namespace Ewoms
 
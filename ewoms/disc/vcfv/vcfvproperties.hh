@@ -41,6 +41,10 @@ NEW_TYPE_TAG(VcfvDiscretization, INHERITS_FROM(FvBaseDiscretization));
 //! Use P1 finite-elements gradients instead of two-point gradients. Note that setting
 //! this property to true requires the dune-localfunctions module to be available.
 NEW_PROP_TAG(UseP1FiniteElementGradients);
+
+//! Specify whether the geometry of the stencils of all elements is computed once per
+//! grid instead of each time an element context is updated.
+NEW_PROP_TAG(EnableGeometryCache);
 }} // namespace Properties, Ewoms
 
 #endif
@@ -45,6 +45,8 @@
 
 #include <dune/common/version.hh>
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace Ewoms {
@@ -803,8 +805,15 @@ public:
         const GlobalPosition& integrationPos() const
         { return ipGlobal_; }
 
+        //! index of the grid's boundary segment which contains the face (the largest
+        //! representable number for interior faces)
+        unsigned boundarySegmentIndex() const
+        { return boundarySegmentIdx_; }
+
         //! scvf seperates corner i and j of elem
         unsigned short i,j;
+        //! boundary segment index of the face
+        unsigned boundarySegmentIdx_;
         //! integration point in local coords
         LocalPosition ipLocal_;
         //! integration point in global coords
@@ -818,6 +827,262 @@ public:
     //! compatibility typedef
     typedef SubControlVolumeFace BoundaryFace;
 
+    typedef Dune::MultipleCodimMultipleGeomTypeMapper<GridView,
+                                                      Dune::MCMGElementLayout > ElementMapper;
+
+    /*!
+     * \brief Stores the geometric part of the stencils of all elements of a grid view.
+     *
+     * The volumes and positions of the sub-control volumes, the integration points,
+     * normals and areas of the interior and boundary faces and -- optionally -- the
+     * values and gradients of the P1 shape functions at the integration points of the
+     * interior faces only depend on the grid. They are thus computed once and stored
+     * quantity by quantity in flat arrays. The entries of an element are contiguous in
+     * each array and located using per-element offsets. A stencil which is attached to
+     * such an object using setGeometryCache() copies this data in update() instead of
+     * evaluating the element's geometry.
+     *
+     * The object must be updated whenever the grid is changed.
+     */
+    class GeometryCache
+    {
+    public:
+        GeometryCache()
+            : elementMapper_(0)
+            , hasShapeFunctions_(false)
+        { }
+
+        /*!
+         * \brief Compute the geometry of the stencils of all elements of a grid view.
+         *
+         * If 'withShapeFunctions' is true, the values and gradients of the P1 shape
+         * functions at the integration points of the interior faces are stored as
+         * well. This requires the dune-localfunctions module.
+         */
+        void update(const GridView& gridView,
+                    const VertexMapper& vertexMapper,
+                    const ElementMapper& elementMapper,
+                    bool withShapeFunctions)
+        {
+#if !HAVE_DUNE_LOCALFUNCTIONS
+            if (withShapeFunctions)
+                OPM_THROW(std::logic_error,
+                          "The dune-localfunctions module is required to cache the values of "
+                          "the shape functions");
+#endif
+            elementMapper_ = &elementMapper;
+            hasShapeFunctions_ = withShapeFunctions;
+
+            size_t numElements = static_cast<size_t>(gridView.size(/*codim=*/0));
+            rowIdx_.assign(numElements, 0);
+
+            elementVolume_.clear();
+            elementGlobal_.clear();
+            numFaces_.clear();
+            scvOffsets_.assign(1, 0);
+            faceOffsets_.assign(1, 0);
+            boundaryFaceOffsets_.assign(1, 0);
+            shapeOffsets_.assign(1, 0);
+
+            scvGlobal_.clear();
+            scvVolume_.clear();
+            faces_.clear();
+            boundaryFaces_.clear();
+            shapeValue_.clear();
+            shapeGradient_.clear();
+
+            // the stencil which is used to compute the data is not attached to any
+            // geometry cache, i.e., it evaluates the geometry of each element.
+            VcfvStencil stencil(gridView, vertexMapper);
+            auto elemIt = gridView.template begin</*codim=*/0>();
+            const auto& elemEndIt = gridView.template end</*codim=*/0>();
+            for (; elemIt != elemEndIt; ++elemIt) {
+                const Element& elem = *elemIt;
+                stencil.update(elem);
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
+                unsigned elemIdx = static_cast<unsigned>(elementMapper.index(elem));
+#else
+                unsigned elemIdx = static_cast<unsigned>(elementMapper.map(elem));
+#endif
+                rowIdx_[elemIdx] = static_cast<unsigned>(elementVolume_.size());
+
+                elementVolume_.push_back(stencil.elementVolume);
+                elementGlobal_.push_back(stencil.elementGlobal);
+                numFaces_.push_back(static_cast<unsigned char>(stencil.numFaces));
+
+                for (unsigned scvIdx = 0; scvIdx < stencil.numVertices; ++scvIdx) {
+                    scvGlobal_.push_back(stencil.subContVol[scvIdx].global);
+                    scvVolume_.push_back(stencil.subContVol[scvIdx].volume_);
+                }
+
+                for (unsigned faceIdx = 0; faceIdx < stencil.numEdges; ++faceIdx)
+                    faces_.push_back(stencil.subContVolFace[faceIdx]);
+
+                for (unsigned bfIdx = 0; bfIdx < stencil.numBoundarySegments_; ++bfIdx)
+                    boundaryFaces_.push_back(stencil.boundaryFace_[bfIdx]);
+
+#if HAVE_DUNE_LOCALFUNCTIONS
+                if (withShapeFunctions)
+                    appendShapeFunctions_(stencil, elem);
+#endif
+
+                scvOffsets_.push_back(scvVolume_.size());
+                faceOffsets_.push_back(faces_.size());
+                boundaryFaceOffsets_.push_back(boundaryFaces_.size());
+                shapeOffsets_.push_back(shapeValue_.size());
+            }
+        }
+
+        /*!
+         * \brief Returns the number of elements for which the geometry is stored.
+         */
+        size_t numElements() const
+        { return rowIdx_.size(); }
+
+        /*!
+         * \brief Returns true iff the values and gradients of the shape functions are
+         *        stored.
+         */
+        bool hasShapeFunctions() const
+        { return hasShapeFunctions_; }
+
+        /*!
+         * \brief Returns the row of an element.
+         */
+        unsigned row(const Element& elem) const
+        {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
+            return rowIdx_[static_cast<size_t>(elementMapper_->index(elem))];
+#else
+            return rowIdx_[static_cast<size_t>(elementMapper_->map(elem))];
+#endif
+        }
+
+        /*!
+         * \brief Returns the values of all shape functions at the integration point of
+         *        an interior face of the element in a given row.
+         */
+        const Scalar* shapeValues(unsigned row, unsigned faceIdx) const
+        {
+            size_t numVertices = scvOffsets_[row + 1] - scvOffsets_[row];
+            return &shapeValue_[shapeOffsets_[row] + faceIdx*numVertices];
+        }
+
+        /*!
+         * \brief Returns the gradients of all shape functions at the integration point
+         *        of an interior face of the element in a given row.
+         */
+        const DimVector* shapeGradients(unsigned row, unsigned faceIdx) const
+        {
+            size_t numVertices = scvOffsets_[row + 1] - scvOffsets_[row];
+            return &shapeGradient_[shapeOffsets_[row] + faceIdx*numVertices];
+        }
+
+        /*!
+         * \brief Returns the number of bytes which are allocated for the cached data.
+         */
+        size_t memoryUsage() const
+        {
+            return
+                rowIdx_.capacity()*sizeof(unsigned)
+                + elementVolume_.capacity()*sizeof(Scalar)
+                + elementGlobal_.capacity()*sizeof(GlobalPosition)
+                + numFaces_.capacity()*sizeof(unsigned char)
+                + (scvOffsets_.capacity()
+                   + faceOffsets_.capacity()
+                   + boundaryFaceOffsets_.capacity()
+                   + shapeOffsets_.capacity())*sizeof(size_t)
+                + scvGlobal_.capacity()*sizeof(GlobalPosition)
+                + scvVolume_.capacity()*sizeof(Scalar)
+                + faces_.capacity()*sizeof(SubControlVolumeFace)
+                + boundaryFaces_.capacity()*sizeof(BoundaryFace)
+                + shapeValue_.capacity()*sizeof(Scalar)
+                + shapeGradient_.capacity()*sizeof(DimVector);
+        }
+
+        /*!
+         * \brief Copy the cached geometry of an element into a stencil.
+         *
+         * The topological part of the stencil must already be set up.
+         */
+        void copyTo(VcfvStencil& stencil, unsigned row) const
+        {
+            stencil.elementVolume = elementVolume_[row];
+            stencil.elementGlobal = elementGlobal_[row];
+            stencil.numFaces = numFaces_[row];
+
+            size_t scvBegin = scvOffsets_[row];
+            for (unsigned scvIdx = 0; scvIdx < stencil.numVertices; ++scvIdx) {
+                stencil.subContVol[scvIdx].global = scvGlobal_[scvBegin + scvIdx];
+                stencil.subContVol[scvIdx].volume_ = scvVolume_[scvBegin + scvIdx];
+            }
+
+            std::copy(faces_.begin() + static_cast<long>(faceOffsets_[row]),
+                      faces_.begin() + static_cast<long>(faceOffsets_[row + 1]),
+                      stencil.subContVolFace);
+
+            stencil.numBoundarySegments_ =
+                static_cast<unsigned>(boundaryFaceOffsets_[row + 1] - boundaryFaceOffsets_[row]);
+            std::copy(boundaryFaces_.begin() + static_cast<long>(boundaryFaceOffsets_[row]),
+                      boundaryFaces_.begin() + static_cast<long>(boundaryFaceOffsets_[row + 1]),
+                      stencil.boundaryFace_);
+        }
+
+    private:
+#if HAVE_DUNE_LOCALFUNCTIONS
+        void appendShapeFunctions_(const VcfvStencil& stencil, const Element& elem)
+        {
+            const auto& localFE = feCache_.get(elem.type());
+            const auto& geom = elem.geometry();
+
+            std::vector<Dune::FieldVector<Scalar, 1> > values;
+            std::vector<ShapeJacobian> localGradients;
+            for (unsigned faceIdx = 0; faceIdx < stencil.numEdges; ++faceIdx) {
+                const auto& localPos = stencil.subContVolFace[faceIdx].localPos();
+                localFE.localBasis().evaluateFunction(localPos, values);
+                localFE.localBasis().evaluateJacobian(localPos, localGradients);
+                const auto& jacInvT = geom.jacobianInverseTransposed(localPos);
+
+                for (unsigned vertIdx = 0; vertIdx < stencil.numVertices; ++vertIdx) {
+                    shapeValue_.push_back(values[vertIdx][0]);
+
+                    DimVector grad;
+                    jacInvT.mv(localGradients[vertIdx][0], grad);
+                    shapeGradient_.push_back(grad);
+                }
+            }
+        }
+#endif
+
+        const ElementMapper* elementMapper_;
+        bool hasShapeFunctions_;
+
+        // element index -> row
+        std::vector<unsigned> rowIdx_;
+
+        // per row
+        std::vector<Scalar> elementVolume_;
+        std::vector<GlobalPosition> elementGlobal_;
+        std::vector<unsigned char> numFaces_;
+        std::vector<size_t> scvOffsets_;
+        std::vector<size_t> faceOffsets_;
+        std::vector<size_t> boundaryFaceOffsets_;
+        std::vector<size_t> shapeOffsets_;
+
+        // per sub-control volume
+        std::vector<GlobalPosition> scvGlobal_;
+        std::vector<Scalar> scvVolume_;
+
+        // per face
+        std::vector<SubControlVolumeFace> faces_;
+        std::vector<BoundaryFace> boundaryFaces_;
+
+        // per interior face and vertex
+        std::vector<Scalar> shapeValue_;
+        std::vector<DimVector> shapeGradient_;
+    };
+
     VcfvStencil(const GridView& gridView, const VertexMapper& vertexMapper)
         : gridView_(gridView)
         , vertexMapper_( vertexMapper )
@@ -826,6 +1091,8 @@ public:
 #else
         , elementPtr_(gridView.template begin</*codim=*/0>())
 #endif
+        , geometryCache_(0)
+        , useGeometryCache_(false)
     {
         static bool localGeometriesInitialized = false;
         if (!localGeometriesInitialized) {
@@ -839,6 +1106,16 @@ public:
         }
     }
 
+    /*!
+     * \brief Copy the geometry of the sub-control volumes from a cache instead of
+     *        computing it in each call to update().
+     *
+     * The cache object must outlive the stencil. Passing a null pointer switches back
+     * to evaluating the geometry of the element.
+     */
+    void setGeometryCache(const GeometryCache* geometryCache)
+    { geometryCache_ = geometryCache; }
+
     /*!
      * \brief Update the non-geometric part of the stencil.
      *
@@ -846,6 +1123,9 @@ public:
      */
     void updateTopology(const Element& e)
     {
+        if (updateFromGeometryCache_(e))
+            return;
+
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
         element_ = e;
 
@@ -883,6 +1163,9 @@ public:
 
     void update(const Element& e)
     {
+        if (updateFromGeometryCache_(e))
+            return;
+
         updateTopology(e);
 
         const Geometry& geometry = e.geometry();
@@ -926,6 +1209,7 @@ public:
                 std::swap(i, j);
             subContVolFace[k].i = i;
             subContVolFace[k].j = j;
+            subContVolFace[k].boundarySegmentIdx_ = std::numeric_limits<unsigned>::max();
 
             // calculate the local integration point and
             // the face normal. note that since dim is a
@@ -1025,6 +1309,8 @@ public:
                 boundaryFace_[bfIdx].ipGlobal_ = geometry.global(boundaryFace_[bfIdx].ipLocal_);
                 boundaryFace_[bfIdx].i = vertInElement;
                 boundaryFace_[bfIdx].j = vertInElement;
+                boundaryFace_[bfIdx].boundarySegmentIdx_ =
+                    static_cast<unsigned>(intersection.boundarySegmentIndex());
 
                 // ASSUME constant normal on the segment of the boundary face
                 boundaryFace_[bfIdx].normal_ = intersection.centerUnitOuterNormal();
@@ -1036,7 +1322,7 @@ public:
 
     void updateScvGeometry(const Element& element)
     {
-        auto geomType = element.geometry().type();
+        auto geomType = element.type();
 
         // get the local geometries of the sub control volumes
         if (geomType.isTriangle() || geomType.isTetrahedron()) {
@@ -1084,6 +1370,28 @@ public:
     }
 #endif
 
+    /*!
+     * \brief Returns the values of all P1 shape functions at the integration point of
+     *        an interior face if they are cached, or a null pointer if they are not.
+     */
+    const Scalar* cachedShapeValues(unsigned faceIdx) const
+    {
+        if (!useGeometryCache_ || !geometryCache_->hasShapeFunctions())
+            return 0;
+        return geometryCache_->shapeValues(cacheRow_, faceIdx);
+    }
+
+    /*!
+     * \brief Returns the gradients of all P1 shape functions at the integration point
+     *        of an interior face if they are cached, or a null pointer if they are not.
+     */
+    const DimVector* cachedShapeGradients(unsigned faceIdx) const
+    {
+        if (!useGeometryCache_ || !geometryCache_->hasShapeFunctions())
+            return 0;
+        return geometryCache_->shapeGradients(cacheRow_, faceIdx);
+    }
+
     unsigned numDof() const
     { return numVertices; }
 
@@ -1150,6 +1458,42 @@ public:
     }
 
 private:
+    // if a geometry cache is attached and up to date, set up the topology of the element
+    // and copy its geometry from the cache
+    bool updateFromGeometryCache_(const Element& e)
+    {
+        useGeometryCache_ =
+            geometryCache_
+            && geometryCache_->numElements() == static_cast<size_t>(gridView_.size(/*codim=*/0));
+        if (!useGeometryCache_)
+            return false;
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2,4)
+        element_ = e;
+
+        numVertices = e.subEntities(/*codim=*/dim);
+        numEdges = e.subEntities(/*codim=*/dim-1);
+#else
+        elementPtr_ = ElementPointer(e);
+
+        numVertices = e.template count</*codim=*/dim>();
+        numEdges = e.template count</*codim=*/dim-1>();
+#endif
+
+        geometryType_ = e.type();
+        const typename Dune::ReferenceElementContainer<CoordScalar,dim>::value_type&
+            referenceElement = Dune::ReferenceElements<CoordScalar,dim>::general(geometryType_);
+        elementLocal = referenceElement.position(0,0);
+        for (unsigned vertexIdx = 0; vertexIdx < numVertices; vertexIdx++)
+            subContVol[vertexIdx].local = referenceElement.position(static_cast<int>(vertexIdx), dim);
+
+        cacheRow_ = geometryCache_->row(e);
+        geometryCache_->copyTo(*this, cacheRow_);
+
+        updateScvGeometry(e);
+        return true;
+    }
+
 #if __GNUC__ || __clang__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -1426,6 +1770,11 @@ private:
     //! number of faces (0 in < 3D)
     unsigned numFaces;
     Dune::GeometryType geometryType_;
+
+    // the cached geometry (if any) and the row of the current element in it
+    const GeometryCache* geometryCache_;
+    bool useGeometryCache_;
+    unsigned cacheRow_;
 };
 
 #if HAVE_DUNE_LOCALFUNCTIONS
@@ -30,6 +30,7 @@
 #include "foreignoverlapfrombcrsmatrix.hh"
 #include "blacklist.hh"
 #include "globalindices.hh"
+#include "reversecuthillmckee.hh"
 
 #include <ewoms/parallel/mpibuffer.hh>
 
@@ -61,16 +62,24 @@ public:
     /*!
      * \brief Constructs the foreign overlap given a BCRS matrix and
      *        an initial list of border indices.
+     *
+     * If 'reorder' is true, the local indices are renumbered using the reverse
+     * Cuthill-McKee algorithm. This only affects the domestic indices, the native ones
+     * stay the same.
      */
     template <class BCRSMatrix>
     DomesticOverlapFromBCRSMatrix(const BCRSMatrix& A,
                                   const BorderList& borderList,
                                   const BlackList& blackList,
-                                  unsigned overlapSize)
+                                  unsigned overlapSize,
+                                  bool reorder = false)
         : foreignOverlap_(A, borderList, blackList, overlapSize)
         , blackList_(blackList)
         , globalIndices_(foreignOverlap_)
     {
+        if (reorder)
+            computeReordering_(A);
+
         myRank_ = 0;
         worldSize_ = 1;
 
@@ -546,19 +555,56 @@ protected:
     void setupDebugMapping_()
     {}
 
-    // this method is intended to map domestic indices to the ones
-    // used by a sequential grid.
-    //
-    // by default, this method does nothing
+    // renumber the local indices using the reverse Cuthill-McKee algorithm on the
+    // graph of the local part of the matrix. the indices of the domestic overlap are
+    // not affected.
+    template <class BCRSMatrix>
+    void computeReordering_(const BCRSMatrix& A)
+    {
+        size_t nLocal = numLocal();
+
+        std::vector<size_t> rowOffsets(nLocal + 1, 0);
+        std::vector<Index> colIndices;
+        colIndices.reserve(nLocal*7);
+        for (unsigned localIdx = 0; localIdx < nLocal; ++localIdx) {
+            Index nativeRowIdx = foreignOverlap_.localToNative(static_cast<Index>(localIdx));
+            const auto& row = A[static_cast<unsigned>(nativeRowIdx)];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt) {
+                Index localColIdx = foreignOverlap_.nativeToLocal(static_cast<Index>(colIt.index()));
+                if (localColIdx < 0 || localColIdx == static_cast<Index>(localIdx))
+                    continue;
+                colIndices.push_back(localColIdx);
+            }
+            rowOffsets[localIdx + 1] = colIndices.size();
+        }
+
+        reverseCuthillMcKee(externalToInternal_, rowOffsets, colIndices);
+
+        internalToExternal_.resize(nLocal);
+        for (unsigned externalIdx = 0; externalIdx < nLocal; ++externalIdx)
+            internalToExternal_[static_cast<unsigned>(externalToInternal_[externalIdx])] =
+                static_cast<Index>(externalIdx);
+    }
+
+    // map the internal domestic indices to the ones which are seen from the outside.
+    // this is the identity unless the local indices have been reordered.
     Index mapInternalToExternal_(Index internalIdx) const
-    { return internalIdx; }
+    {
+        if (internalIdx < 0 || static_cast<size_t>(internalIdx) >= internalToExternal_.size())
+            return internalIdx;
+        return internalToExternal_[static_cast<unsigned>(internalIdx)];
+    }
 
-    // this method is intended to map the indices used by a sequential
-    // to grid domestic indices ones.
-    //
-    // by default, this method does nothing
+    // map the domestic indices which are seen from the outside to the internal ones.
+    // this is the identity unless the local indices have been reordered.
     Index mapExternalToInternal_(Index externalIdx) const
-    { return externalIdx; }
+    {
+        if (externalIdx < 0 || static_cast<size_t>(externalIdx) >= externalToInternal_.size())
+            return externalIdx;
+        return externalToInternal_[static_cast<unsigned>(externalIdx)];
+    }
 
     ProcessRank myRank_;
     unsigned worldSize_;
@@ -575,6 +621,10 @@ protected:
     std::map<ProcessRank, MpiBuffer<IndexDistanceNpeers> *> indicesSendBuffer_;
     GlobalIndices globalIndices_;
     PeerSet peerSet_;
+
+    // the permutation of the local indices (empty if they are not reordered)
+    std::vector<Index> internalToExternal_;
+    std::vector<Index> externalToInternal_;
 };
 
 } // namespace Linear
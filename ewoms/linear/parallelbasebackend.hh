@@ -86,6 +86,16 @@ NEW_PROP_TAG(LinearSolverScalar);
  */
 NEW_PROP_TAG(LinearSolverOverlapSize);
 
+/*!
+ * \brief Specify whether the unknowns of the linear solver should be renumbered using
+ *        the reverse Cuthill-McKee algorithm.
+ *
+ * This reduces the bandwidth of the matrix seen by the linear solver, which usually
+ * improves the cache locality and the quality of the ILU preconditioners. The numbering
+ * of the degrees of freedom used by the model is not affected.
+ */
+NEW_PROP_TAG(LinearSolverReordering);
+
 /*!
  * \brief Maximum accepted error of the solution of the linear solver.
  */
@@ -176,6 +186,9 @@ public:
         overlappingMatrix_ = nullptr;
         overlappingb_ = nullptr;
         overlappingx_ = nullptr;
+
+        tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        matrixUnchanged_ = false;
     }
 
     ~ParallelBaseBackend()
@@ -190,6 +203,9 @@ public:
                              "The maximum allowed error between of the linear solver");
         EWOMS_REGISTER_PARAM(TypeTag, unsigned, LinearSolverOverlapSize,
                              "The size of the algebraic overlap for the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverReordering,
+                             "Renumber the unknowns of the linear solver using the reverse "
+                             "Cuthill-McKee algorithm");
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverMaxIterations,
                              "The maximum number of iterations of the linear solver");
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverVerbosity,
@@ -205,6 +221,22 @@ public:
     void eraseMatrix()
     { cleanup_(); }
 
+    /*!
+     * \brief Set the reduction of the residual which is required by the next calls to
+     *        solve().
+     *
+     * By default, the value of the LinearSolverTolerance parameter is used.
+     */
+    void setTolerance(Scalar value)
+    { tolerance_ = value; }
+
+    /*!
+     * \brief Returns the reduction of the residual which is required by the linear
+     *        solver.
+     */
+    Scalar tolerance() const
+    { return tolerance_; }
+
     void prepareMatrix(const Matrix& M)
     {
         // make sure that the overlapping matrix and block vectors
@@ -223,6 +255,26 @@ public:
         overlappingMatrix_->syncAdd();
         // the entries on the border have already been added in prepareRhs()
         overlappingb_->sync();
+
+        matrixUnchanged_ = false;
+    }
+
+    /*!
+     * \brief Prepare solving a linear system of equations whose matrix is the one which
+     *        was passed to the last call of prepareMatrix().
+     *
+     * This is an alternative to prepareMatrix(): Only the right hand side passed to
+     * prepareRhs() is updated, and the preconditioner which was constructed by the
+     * previous call to solve() is reused.
+     */
+    void prepareUnchangedMatrix()
+    {
+        asImp_().rescaleRhs_();
+
+        // the entries on the border have already been added in prepareRhs()
+        overlappingb_->sync();
+
+        matrixUnchanged_ = true;
     }
 
     void prepareRhs(const Matrix& M, Vector& b)
@@ -249,13 +301,22 @@ public:
     {
         (*overlappingx_) = 0.0;
 
-        auto parPreCond = asImp_().preparePreconditioner_();
-
-        auto cleanupPrecondFn =
-            [this]() -> void
-            { this->asImp_().cleanupPreconditioner_(); };
+        // the preconditioner is kept until the matrix changes. since its type depends on
+        // the backend, it is stored type-erased.
+        typedef decltype(asImp_().preparePreconditioner_()) PreconditionerPtr;
+        typedef typename PreconditionerPtr::element_type PreconditionerType;
+        PreconditionerPtr parPreCond;
+        if (matrixUnchanged_ && preconditioner_)
+            parPreCond = std::static_pointer_cast<PreconditionerType>(preconditioner_);
+        else {
+            if (preconditioner_) {
+                preconditioner_.reset();
+                asImp_().cleanupPreconditioner_();
+            }
 
-        GenericGuard<decltype(cleanupPrecondFn)> precondGuard(cleanupPrecondFn);
+            parPreCond = asImp_().preparePreconditioner_();
+            preconditioner_ = parPreCond;
+        }
 
         // create the parallel scalar product and the parallel operator
         ParallelScalarProduct parScalarProduct(overlappingMatrix_->overlap());
@@ -305,10 +366,12 @@ protected:
 
         // create the overlapping Jacobian matrix
         unsigned overlapSize = EWOMS_GET_PARAM(TypeTag, unsigned, LinearSolverOverlapSize);
+        bool reorder = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverReordering);
         overlappingMatrix_ = new OverlappingMatrix(M,
                                                    borderListCreator.borderList(),
                                                    borderListCreator.blackList(),
-                                                   overlapSize);
+                                                   overlapSize,
+                                                   reorder);
 
         // create the overlapping vectors for the residual and the
         // solution
@@ -332,7 +395,16 @@ protected:
                 for (unsigned i = 0; i < entry.rows; ++i)
                     entry[i] *= simulator_.model().eqWeight(nativeRowIdx, i);
             }
+        }
 
+        asImp_().rescaleRhs_();
+    }
+
+    void rescaleRhs_()
+    {
+        const auto& overlap = overlappingMatrix_->overlap();
+        for (unsigned domesticRowIdx = 0; domesticRowIdx < overlap.numLocal(); ++domesticRowIdx) {
+            Index nativeRowIdx = overlap.domesticToNative(static_cast<Index>(domesticRowIdx));
             auto& rhsEntry = (*overlappingb_)[domesticRowIdx];
             for (unsigned i = 0; i < rhsEntry.size(); ++i)
                 rhsEntry[i] *= simulator_.model().eqWeight(nativeRowIdx, i);
@@ -341,6 +413,10 @@ protected:
 
     void cleanup_()
     {
+        // the preconditioner refers to the overlapping matrix
+        preconditioner_.reset();
+        precWrapper_.cleanup();
+
         // create the overlapping Jacobian matrix and vectors
         delete overlappingMatrix_;
         delete overlappingb_;
@@ -425,6 +501,10 @@ protected:
     OverlappingVector *overlappingx_;
 
     PreconditionerWrapper precWrapper_;
+    std::shared_ptr<void> preconditioner_;
+    bool matrixUnchanged_;
+
+    Scalar tolerance_;
 };
 }} // namespace Linear, Ewoms
 
@@ -489,6 +569,9 @@ SET_TYPE_PROP(ParallelBaseLinearSolver,
 //! set the default overlap size to 2
 SET_INT_PROP(ParallelBaseLinearSolver, LinearSolverOverlapSize, 2);
 
+//! do not renumber the unknowns of the linear solver by default
+SET_BOOL_PROP(ParallelBaseLinearSolver, LinearSolverReordering, false);
+
 //! set the default number of maximum iterations for the linear solver
 SET_INT_PROP(ParallelBaseLinearSolver, LinearSolverMaxIterations, 1000);
 } // namespace Properties
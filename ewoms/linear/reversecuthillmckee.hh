@@ -0,0 +1,164 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::Linear::reverseCuthillMcKee
+ */
+#ifndef EWOMS_REVERSE_CUTHILL_MCKEE_HH
+#define EWOMS_REVERSE_CUTHILL_MCKEE_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Ewoms {
+namespace Linear {
+
+//! \cond SKIP_THIS
+namespace RcmDetail {
+// do a breadth-first search starting at a given vertex and append the visited vertices
+// to 'order'. the neighbors of each vertex are visited by ascending degree. returns the
+// position of the first vertex of the last level set in 'order'.
+template <class Index>
+size_t bfs(std::vector<Index>& order,
+           size_t& numLevels,
+           std::vector<char>& visited,
+           const std::vector<size_t>& rowOffsets,
+           const std::vector<Index>& colIndices,
+           Index startIdx)
+{
+    auto degree = [&rowOffsets](Index idx)
+        { return rowOffsets[static_cast<size_t>(idx) + 1] - rowOffsets[static_cast<size_t>(idx)]; };
+
+    size_t head = order.size();
+    size_t lastLevelBegin = head;
+    size_t curLevelEnd = head + 1;
+    numLevels = 1;
+    order.push_back(startIdx);
+    visited[static_cast<size_t>(startIdx)] = 1;
+
+    while (head < order.size()) {
+        if (head == curLevelEnd) {
+            // a new level set begins
+            lastLevelBegin = head;
+            curLevelEnd = order.size();
+            ++numLevels;
+        }
+
+        Index idx = order[head++];
+        size_t neighborsBegin = order.size();
+        for (size_t k = rowOffsets[static_cast<size_t>(idx)]; k < rowOffsets[static_cast<size_t>(idx) + 1]; ++k) {
+            Index neighborIdx = colIndices[k];
+            if (visited[static_cast<size_t>(neighborIdx)])
+                continue;
+
+            visited[static_cast<size_t>(neighborIdx)] = 1;
+            order.push_back(neighborIdx);
+        }
+
+        std::sort(order.begin() + static_cast<long>(neighborsBegin), order.end(),
+                  [&degree](Index a, Index b)
+                  { return degree(a) < degree(b); });
+    }
+
+    return lastLevelBegin;
+}
+} // namespace RcmDetail
+//! \endcond
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Computes the reverse Cuthill-McKee ordering of an undirected graph.
+ *
+ * The graph is given in compressed row storage format, i.e., the neighbors of vertex i
+ * are colIndices[rowOffsets[i]] to colIndices[rowOffsets[i + 1] - 1]. The result is
+ * written to 'order' such that order[newIdx] is the index of the vertex which ends up
+ * at position newIdx. Each connected component is started at a pseudo-peripheral
+ * vertex which is found using the heuristic by George and Liu.
+ *
+ * Renumbering the unknowns of a sparse matrix this way reduces its bandwidth. This
+ * usually improves the cache locality of sparse matrix-vector products and the quality
+ * of incomplete LU factorizations.
+ */
+template <class Index>
+void reverseCuthillMcKee(std::vector<Index>& order,
+                         const std::vector<size_t>& rowOffsets,
+                         const std::vector<Index>& colIndices)
+{
+    assert(!rowOffsets.empty());
+    size_t numVertices = rowOffsets.size() - 1;
+
+    auto degree = [&rowOffsets](Index idx)
+        { return rowOffsets[static_cast<size_t>(idx) + 1] - rowOffsets[static_cast<size_t>(idx)]; };
+
+    order.clear();
+    order.reserve(numVertices);
+    std::vector<char> visited(numVertices, 0);
+    std::vector<Index> componentOrder;
+
+    for (size_t seedIdx = 0; seedIdx < numVertices; ++seedIdx) {
+        if (visited[seedIdx])
+            continue;
+
+        // find a pseudo-peripheral vertex of the connected component: starting with the
+        // seed, move to a vertex of minimum degree in the last level set as long as this
+        // increases the number of level sets.
+        Index startIdx = static_cast<Index>(seedIdx);
+        size_t numLevels = 0;
+        while (true) {
+            componentOrder.clear();
+            size_t newNumLevels;
+            size_t lastLevelBegin =
+                RcmDetail::bfs(componentOrder, newNumLevels, visited, rowOffsets, colIndices, startIdx);
+
+            for (Index idx : componentOrder)
+                visited[static_cast<size_t>(idx)] = 0;
+
+            if (newNumLevels <= numLevels)
+                break;
+            numLevels = newNumLevels;
+
+            Index nextStartIdx = componentOrder[lastLevelBegin];
+            for (size_t i = lastLevelBegin + 1; i < componentOrder.size(); ++i)
+                if (degree(componentOrder[i]) < degree(nextStartIdx))
+                    nextStartIdx = componentOrder[i];
+
+            if (nextStartIdx == startIdx)
+                break;
+            startIdx = nextStartIdx;
+        }
+
+        size_t tmp;
+        RcmDetail::bfs(order, tmp, visited, rowOffsets, colIndices, startIdx);
+    }
+
+    assert(order.size() == numVertices);
+    std::reverse(order.begin(), order.end());
+}
+
+} // namespace Linear
+} // namespace Ewoms
+
+#endif
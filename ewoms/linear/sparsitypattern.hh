@@ -0,0 +1,248 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::Linear::SparsityPattern
+ */
+#ifndef EWOMS_SPARSITY_PATTERN_HH
+#define EWOMS_SPARSITY_PATTERN_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Ewoms {
+namespace Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Assembles the sparsity pattern of a square matrix in compressed row storage
+ *        (CSR) format.
+ *
+ * The pattern is built in two passes: First, an upper bound for the number of entries
+ * of each row is specified via countEntries(), then the column indices are added using
+ * addEntry(). Both methods are thread safe, so that both passes can be parallelized
+ * over the elements of the grid. Finally, calling finalize() sorts the column indices
+ * of each row and removes the duplicates.
+ *
+ * Compared to a vector of std::set objects, this avoids a heap allocation for each
+ * matrix entry and makes the memory required for the pattern proportional to the number
+ * of non-zero blocks.
+ */
+class SparsityPattern
+{
+public:
+    SparsityPattern()
+    { clear(); }
+
+    /*!
+     * \brief Start assembling a new pattern for a matrix with a given number of rows.
+     *
+     * After calling this method, the object is in the counting phase.
+     */
+    void reset(size_t numRows)
+    {
+        numRows_ = numRows;
+        rowOffsets_.assign(numRows + 1, 0);
+        fillPos_.clear();
+        colIndices_.clear();
+    }
+
+    /*!
+     * \brief Release all memory used by the pattern.
+     */
+    void clear()
+    {
+        numRows_ = 0;
+        std::vector<size_t>().swap(rowOffsets_);
+        std::vector<size_t>().swap(fillPos_);
+        std::vector<unsigned>().swap(colIndices_);
+    }
+
+    /*!
+     * \brief Reserve space for a given number of additional entries in a row.
+     *
+     * It does not matter if the same column index is later added multiple times as
+     * long as enough space was reserved. This method is thread safe.
+     */
+    void countEntries(unsigned rowIdx, unsigned numEntries)
+    {
+        assert(rowIdx < numRows_);
+        assert(fillPos_.empty());
+
+        // the counter for row i is stored at position i + 1 so that the prefix sum can
+        // be computed in place
+        size_t& count = rowOffsets_[rowIdx + 1];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        count += numEntries;
+    }
+
+    /*!
+     * \brief Finish the counting phase and allocate space for the column indices.
+     */
+    void beginFill()
+    {
+        assert(fillPos_.empty());
+
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            rowOffsets_[rowIdx + 1] += rowOffsets_[rowIdx];
+
+        fillPos_.assign(rowOffsets_.begin(), rowOffsets_.end() - 1);
+        colIndices_.resize(rowOffsets_[numRows_]);
+    }
+
+    /*!
+     * \brief Add a column index to a row.
+     *
+     * beginFill() must have been called before and enough space must have been reserved
+     * for the row using countEntries(). This method is thread safe.
+     */
+    void addEntry(unsigned rowIdx, unsigned colIdx)
+    {
+        assert(rowIdx < numRows_);
+        assert(!fillPos_.empty());
+
+        size_t pos;
+        size_t& rowFillPos = fillPos_[rowIdx];
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+        pos = rowFillPos++;
+
+        assert(pos < rowOffsets_[rowIdx + 1]);
+        colIndices_[pos] = colIdx;
+    }
+
+    /*!
+     * \brief Sort the column indices of each row, remove the duplicates and compress
+     *        the result.
+     */
+    void finalize()
+    {
+        assert(!fillPos_.empty() || numRows_ == 0);
+
+        // sort and unique each row in place. the number of unique entries of a row is
+        // stored in the fill position array.
+        int numRows = static_cast<int>(numRows_);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            auto rowBegin = colIndices_.begin() + static_cast<long>(rowOffsets_[rowIdx]);
+            auto rowEnd = colIndices_.begin() + static_cast<long>(fillPos_[rowIdx]);
+            std::sort(rowBegin, rowEnd);
+            fillPos_[rowIdx] = static_cast<size_t>(std::unique(rowBegin, rowEnd) - rowBegin);
+        }
+
+        // compress the column indices
+        size_t numEntries = 0;
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            size_t rowBegin = rowOffsets_[rowIdx];
+            size_t rowSize = fillPos_[rowIdx];
+            std::copy(colIndices_.begin() + static_cast<long>(rowBegin),
+                      colIndices_.begin() + static_cast<long>(rowBegin + rowSize),
+                      colIndices_.begin() + static_cast<long>(numEntries));
+            rowOffsets_[rowIdx] = numEntries;
+            numEntries += rowSize;
+        }
+        rowOffsets_[numRows_] = numEntries;
+
+        colIndices_.resize(numEntries);
+        colIndices_.shrink_to_fit();
+        std::vector<size_t>().swap(fillPos_);
+    }
+
+    /*!
+     * \brief Returns the number of rows of the pattern.
+     */
+    size_t numRows() const
+    { return numRows_; }
+
+    /*!
+     * \brief Returns the total number of entries of the finalized pattern.
+     */
+    size_t numEntries() const
+    { return rowOffsets_[numRows_]; }
+
+    /*!
+     * \brief Returns the number of entries in a row of the finalized pattern.
+     */
+    size_t rowSize(unsigned rowIdx) const
+    { return rowOffsets_[rowIdx + 1] - rowOffsets_[rowIdx]; }
+
+    /*!
+     * \brief Returns a pointer to the first column index of a row of the finalized
+     *        pattern.
+     */
+    const unsigned* rowBegin(unsigned rowIdx) const
+    { return colIndices_.data() + rowOffsets_[rowIdx]; }
+
+    /*!
+     * \brief Returns a pointer after the last column index of a row of the finalized
+     *        pattern.
+     */
+    const unsigned* rowEnd(unsigned rowIdx) const
+    { return colIndices_.data() + rowOffsets_[rowIdx + 1]; }
+
+    /*!
+     * \brief Set up the structure of a Dune::BCRSMatrix which was created using the
+     *        'random' build mode.
+     *
+     * Since the exact size of each row is known and the column indices are sorted,
+     * adding an index only appends to the row. (The 'row_wise' build mode would use a
+     * std::set for each row internally.)
+     */
+    template <class BCRSMatrix>
+    void setupMatrix(BCRSMatrix& matrix) const
+    {
+        assert(matrix.N() == numRows_);
+
+        for (unsigned rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            matrix.setrowsize(rowIdx, rowSize(rowIdx));
+        matrix.endrowsizes();
+
+        for (unsigned rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            const unsigned* colIt = rowBegin(rowIdx);
+            const unsigned* colEndIt = rowEnd(rowIdx);
+            for (; colIt != colEndIt; ++colIt)
+                matrix.addindex(rowIdx, *colIt);
+        }
+        matrix.endindices();
+    }
+
+private:
+    size_t numRows_;
+    std::vector<size_t> rowOffsets_;
+    std::vector<size_t> fillPos_;
+    std::vector<unsigned> colIndices_;
+};
+
+} // namespace Linear
+} // namespace Ewoms
+
+#endif
@@ -87,11 +87,28 @@ public:
     void eraseMatrix()
     { }
 
+    /*!
+     * \brief Set the reduction of the residual which is required by the linear solver.
+     *
+     * Since SuperLU is a direct solver, this is a no-op.
+     */
+    void setTolerance(Scalar value OPM_UNUSED)
+    { }
+
     void prepareMatrix(const Matrix& M)
     {
         M_ = &M;
     }
 
+    /*!
+     * \brief Prepare solving a linear system of equations whose matrix is the one which
+     *        was passed to the last call of prepareMatrix().
+     *
+     * Since the SuperLU backend factorizes the matrix for each solve, this is a no-op.
+     */
+    void prepareUnchangedMatrix()
+    { }
+
     void prepareRhs(const Matrix& M OPM_UNUSED, Vector& b)
     {
         b_ = &b;
@@ -43,6 +43,9 @@
 #include <utility>
 
 namespace Ewoms {
+template <class TypeTag>
+class BlackOilIntensiveQuantitiesFieldStorage;
+
 /*!
  * \ingroup BlackOilModel
  * \ingroup IntensiveQuantities
@@ -278,36 +281,7 @@ public:
         Opm::Valgrind::CheckDefined(mobility_);
 
         // calculate the phase densities
-        Evaluation rho;
-        if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
-            rho = fluidState_.invB(waterPhaseIdx);
-            rho *= FluidSystem::referenceDensity(waterPhaseIdx, pvtRegionIdx);
-            fluidState_.setDensity(waterPhaseIdx, rho);
-        }
-
-        if (FluidSystem::phaseIsActive(gasPhaseIdx)) {
-            rho = fluidState_.invB(gasPhaseIdx);
-            rho *= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
-            if (FluidSystem::enableVaporizedOil()) {
-                rho +=
-                    fluidState_.invB(gasPhaseIdx) *
-                    fluidState_.Rv() *
-                    FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
-            }
-            fluidState_.setDensity(gasPhaseIdx, rho);
-        }
-
-        if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
-            rho = fluidState_.invB(oilPhaseIdx);
-            rho *= FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
-            if (FluidSystem::enableDissolvedGas()) {
-                rho +=
-                    fluidState_.invB(oilPhaseIdx) *
-                    fluidState_.Rs() *
-                    FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
-            }
-            fluidState_.setDensity(oilPhaseIdx, rho);
-        }
+        updateDensities_();
 
         // retrieve the porosity from the problem
         porosity_ = problem.porosity(elemCtx, dofIdx, timeIdx);
@@ -393,6 +367,45 @@ public:
 private:
     friend BlackOilSolventIntensiveQuantities<TypeTag>;
     friend BlackOilPolymerIntensiveQuantities<TypeTag>;
+    friend BlackOilIntensiveQuantitiesFieldStorage<TypeTag>;
+
+    // calculate the phase densities from the inverse formation volume factors and the
+    // compositions of the phases
+    void updateDensities_()
+    {
+        unsigned pvtRegionIdx = fluidState_.pvtRegionIndex();
+
+        Evaluation rho;
+        if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
+            rho = fluidState_.invB(waterPhaseIdx);
+            rho *= FluidSystem::referenceDensity(waterPhaseIdx, pvtRegionIdx);
+            fluidState_.setDensity(waterPhaseIdx, rho);
+        }
+
+        if (FluidSystem::phaseIsActive(gasPhaseIdx)) {
+            rho = fluidState_.invB(gasPhaseIdx);
+            rho *= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
+            if (FluidSystem::enableVaporizedOil()) {
+                rho +=
+                    fluidState_.invB(gasPhaseIdx) *
+                    fluidState_.Rv() *
+                    FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
+            }
+            fluidState_.setDensity(gasPhaseIdx, rho);
+        }
+
+        if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
+            rho = fluidState_.invB(oilPhaseIdx);
+            rho *= FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
+            if (FluidSystem::enableDissolvedGas()) {
+                rho +=
+                    fluidState_.invB(oilPhaseIdx) *
+                    fluidState_.Rs() *
+                    FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
+            }
+            fluidState_.setDensity(oilPhaseIdx, rho);
+        }
+    }
 
 
     Implementation& asImp_()
@@ -0,0 +1,226 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::BlackOilIntensiveQuantitiesFieldStorage
+ */
+#ifndef EWOMS_BLACK_OIL_INTENSIVE_QUANTITIES_FIELD_STORAGE_HH
+#define EWOMS_BLACK_OIL_INTENSIVE_QUANTITIES_FIELD_STORAGE_HH
+
+#include "blackoilproperties.hh"
+#include "blackoilintensivequantities.hh"
+
+#include <ewoms/disc/common/fvbaseintensivequantitiesfieldstorage.hh>
+#include <ewoms/common/prefetch.hh>
+
+#include <type_traits>
+#include <vector>
+
+namespace Ewoms {
+/*!
+ * \ingroup BlackOilModel
+ *
+ * \brief Stores the intensive quantities of the black-oil model field by field.
+ *
+ * Only the quantities which are needed by the storage and flux terms and which cannot
+ * be cheaply derived from others are stored: The pressures, saturations and mobilities
+ * of all phases, the inverse formation volume factors of the active phases, the gas
+ * dissolution and oil vaporization factors, the porosity, the extrusion factor and the
+ * PVT region index. The densities of the phases are recalculated when an intensive
+ * quantities object is reconstructed.
+ *
+ * The solvent and polymer extensions are not supported.
+ */
+template <class TypeTag>
+class BlackOilIntensiveQuantitiesFieldStorage
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+    typedef typename GET_PROP_TYPE(TypeTag, Evaluation) Evaluation;
+    typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
+    typedef typename GET_PROP_TYPE(TypeTag, FluxModule) FluxModule;
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+    typedef typename FluxModule::FluxIntensiveQuantities FluxIntensiveQuantities;
+    typedef Ewoms::BlackOilIntensiveQuantities<TypeTag> BlackOilIntQuants;
+    typedef Ewoms::EvaluationFieldArray<Evaluation> FieldArray;
+
+    enum { numPhases = GET_PROP_VALUE(TypeTag, NumPhases) };
+    enum { enableSolvent = GET_PROP_VALUE(TypeTag, EnableSolvent) };
+    enum { enablePolymer = GET_PROP_VALUE(TypeTag, EnablePolymer) };
+
+public:
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::isSupported
+     */
+    static bool isSupported()
+    {
+        // the extensions and flux modules which need their own intensive quantities
+        // would require to store additional fields
+        return
+            !enableSolvent
+            && !enablePolymer
+            && std::is_empty<FluxIntensiveQuantities>::value;
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::resize
+     */
+    void resize(size_t numDof, bool singlePrecisionDerivatives)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx].resize(numDof, singlePrecisionDerivatives);
+            saturation_[phaseIdx].resize(numDof, singlePrecisionDerivatives);
+            invB_[phaseIdx].resize(numDof, singlePrecisionDerivatives);
+            mobility_[phaseIdx].resize(numDof, singlePrecisionDerivatives);
+        }
+        Rs_.resize(numDof, singlePrecisionDerivatives);
+        Rv_.resize(numDof, singlePrecisionDerivatives);
+        porosity_.resize(numDof, singlePrecisionDerivatives);
+        extrusionFactor_.resize(numDof);
+        pvtRegionIdx_.resize(numDof);
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::store
+     */
+    void store(unsigned dofIdx, const IntensiveQuantities& intQuants)
+    {
+        const auto& fs = intQuants.fluidState();
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx].store(dofIdx, fs.pressure(phaseIdx));
+            saturation_[phaseIdx].store(dofIdx, fs.saturation(phaseIdx));
+            mobility_[phaseIdx].store(dofIdx, intQuants.mobility(phaseIdx));
+            if (FluidSystem::phaseIsActive(phaseIdx))
+                invB_[phaseIdx].store(dofIdx, fs.invB(phaseIdx));
+        }
+        Rs_.store(dofIdx, fs.Rs());
+        Rv_.store(dofIdx, fs.Rv());
+        porosity_.store(dofIdx, intQuants.porosity());
+        extrusionFactor_[dofIdx] = intQuants.extrusionFactor();
+        pvtRegionIdx_[dofIdx] = static_cast<unsigned short>(intQuants.pvtRegionIndex());
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::load
+     */
+    void load(IntensiveQuantities& intQuants, unsigned dofIdx) const
+    {
+        BlackOilIntQuants& dest = intQuants;
+        auto& fs = dest.fluidState_;
+
+        Evaluation tmp;
+        fs.setPvtRegionIndex(pvtRegionIdx_[dofIdx]);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx].load(tmp, dofIdx);
+            fs.setPressure(phaseIdx, tmp);
+            saturation_[phaseIdx].load(tmp, dofIdx);
+            fs.setSaturation(phaseIdx, tmp);
+            mobility_[phaseIdx].load(dest.mobility_[phaseIdx], dofIdx);
+            if (FluidSystem::phaseIsActive(phaseIdx)) {
+                invB_[phaseIdx].load(tmp, dofIdx);
+                fs.setInvB(phaseIdx, tmp);
+            }
+        }
+        Rs_.load(tmp, dofIdx);
+        fs.setRs(tmp);
+        Rv_.load(tmp, dofIdx);
+        fs.setRv(tmp);
+        porosity_.load(dest.porosity_, dofIdx);
+        dest.setExtrusionFactor_(extrusionFactor_[dofIdx]);
+
+        dest.updateDensities_();
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::copyEntry
+     */
+    void copyEntry(unsigned dofIdx, const BlackOilIntensiveQuantitiesFieldStorage& other)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx].copyEntry(dofIdx, other.pressure_[phaseIdx]);
+            saturation_[phaseIdx].copyEntry(dofIdx, other.saturation_[phaseIdx]);
+            mobility_[phaseIdx].copyEntry(dofIdx, other.mobility_[phaseIdx]);
+            if (FluidSystem::phaseIsActive(phaseIdx))
+                invB_[phaseIdx].copyEntry(dofIdx, other.invB_[phaseIdx]);
+        }
+        Rs_.copyEntry(dofIdx, other.Rs_);
+        Rv_.copyEntry(dofIdx, other.Rv_);
+        porosity_.copyEntry(dofIdx, other.porosity_);
+        extrusionFactor_[dofIdx] = other.extrusionFactor_[dofIdx];
+        pvtRegionIdx_[dofIdx] = other.pvtRegionIdx_[dofIdx];
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::prefetch
+     */
+    void prefetch(unsigned dofIdx) const
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx].prefetch(dofIdx);
+            saturation_[phaseIdx].prefetch(dofIdx);
+            mobility_[phaseIdx].prefetch(dofIdx);
+            if (FluidSystem::phaseIsActive(phaseIdx))
+                invB_[phaseIdx].prefetch(dofIdx);
+        }
+        Rs_.prefetch(dofIdx);
+        Rv_.prefetch(dofIdx);
+        porosity_.prefetch(dofIdx);
+        Ewoms::prefetch(extrusionFactor_[dofIdx]);
+        Ewoms::prefetch(pvtRegionIdx_[dofIdx]);
+    }
+
+    /*!
+     * \copydoc FvBaseIntensiveQuantitiesFieldStorage::memoryUsage
+     */
+    size_t memoryUsage() const
+    {
+        size_t result = 0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            result += pressure_[phaseIdx].memoryUsage();
+            result += saturation_[phaseIdx].memoryUsage();
+            result += invB_[phaseIdx].memoryUsage();
+            result += mobility_[phaseIdx].memoryUsage();
+        }
+        result += Rs_.memoryUsage();
+        result += Rv_.memoryUsage();
+        result += porosity_.memoryUsage();
+        result += extrusionFactor_.capacity()*sizeof(Scalar);
+        result += pvtRegionIdx_.capacity()*sizeof(unsigned short);
+        return result;
+    }
+
+private:
+    FieldArray pressure_[numPhases];
+    FieldArray saturation_[numPhases];
+    FieldArray invB_[numPhases];
+    FieldArray mobility_[numPhases];
+    FieldArray Rs_;
+    FieldArray Rv_;
+    FieldArray porosity_;
+    std::vector<Scalar> extrusionFactor_;
+    std::vector<unsigned short> pvtRegionIdx_;
+};
+
+} // namespace Ewoms
+
+#endif
@@ -36,6 +36,7 @@
 #include "blackoilextensivequantities.hh"
 #include "blackoilprimaryvariables.hh"
 #include "blackoilintensivequantities.hh"
+#include "blackoilintensivequantitiesfieldstorage.hh"
 #include "blackoilratevector.hh"
 #include "blackoilboundaryratevector.hh"
 #include "blackoillocalresidual.hh"
@@ -99,6 +100,10 @@ SET_TYPE_PROP(BlackOilModel, PrimaryVariables, Ewoms::BlackOilPrimaryVariables<T
 //! the IntensiveQuantities property
 SET_TYPE_PROP(BlackOilModel, IntensiveQuantities, Ewoms::BlackOilIntensiveQuantities<TypeTag>);
 
+//! the class which stores the intensive quantities field by field
+SET_TYPE_PROP(BlackOilModel, IntensiveQuantitiesFieldStorage,
+              Ewoms::BlackOilIntensiveQuantitiesFieldStorage<TypeTag>);
+
 //! the ExtensiveQuantities property
 SET_TYPE_PROP(BlackOilModel, ExtensiveQuantities, Ewoms::BlackOilExtensiveQuantities<TypeTag>);
 
@@ -212,6 +217,9 @@ class BlackOilModel
     static const bool compositionSwitchEnabled = Indices::gasEnabled;
     static const bool waterEnabled = Indices::waterEnabled;
 
+    // the number of possible meanings of the primary variables
+    static const unsigned numPrimaryVarsMeanings_ = PrimaryVariables::Sw_pg_Rv + 1;
+
     typedef BlackOilSolventModule<TypeTag> SolventModule;
     typedef BlackOilPolymerModule<TypeTag> PolymerModule;
 
@@ -357,6 +365,48 @@ public:
         return 1.0;
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::canExtrapolate
+     */
+    bool canExtrapolate(const PrimaryVariables& pv1, const PrimaryVariables& pv2) const
+    {
+        return
+            pv1.primaryVarsMeaning() == pv2.primaryVarsMeaning()
+            && pv1.pvtRegionIndex() == pv2.pvtRegionIndex();
+    }
+
+    /*!
+     * \copydoc FvBaseDiscretization::isAdmissiblePrediction
+     */
+    bool isAdmissiblePrediction(unsigned globalDofIdx, const PrimaryVariables& pv) const
+    {
+        if (!ParentType::isAdmissiblePrediction(globalDofIdx, pv))
+            return false;
+
+        if (pv[Indices::pressureSwitchIdx] <= 0.0)
+            return false;
+
+        Scalar Sw = 0.0;
+        if (waterEnabled) {
+            Sw = pv[Indices::waterSaturationIdx];
+            if (Sw < 0.0 || Sw > 1.0)
+                return false;
+        }
+
+        if (compositionSwitchEnabled) {
+            Scalar x = pv[Indices::compositionSwitchIdx];
+            if (x < 0.0)
+                return false;
+            if (pv.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg && Sw + x > 1.0)
+                return false;
+        }
+
+        // the extrapolation is only trusted if it does not make a phase appear or
+        // disappear, i.e., if it does not require to switch the primary variables
+        PrimaryVariables tmp(pv);
+        return !tmp.adaptPrimaryVariables(this->simulator_.problem(), globalDofIdx);
+    }
+
     /*!
      * \brief Write the current solution for a degree of freedom to a
      *        restart file.
@@ -477,6 +527,20 @@ public:
         this->solution(/*timeIdx=*/1) = this->solution(/*timeIdx=*/0);
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::intensiveQuantitiesBatchKey
+     *
+     * For the black-oil model, the intensive quantities of degrees of freedom which
+     * belong to the same PVT region and use the same meaning of the primary variables
+     * are evaluated using the same branches and the same PVT tables.
+     */
+    unsigned intensiveQuantitiesBatchKey(unsigned globalDofIdx, unsigned timeIdx) const
+    {
+        const PrimaryVariables& priVars = this->solution(timeIdx)[globalDofIdx];
+        return priVars.pvtRegionIndex()*numPrimaryVarsMeanings_
+            + static_cast<unsigned>(priVars.primaryVarsMeaning());
+    }
+
     /*!
      * \brief Returns an elements maximum oil phase saturation observed during the
      *        simulation.
@@ -34,6 +34,8 @@
 
 #include <opm/common/Unused.hpp>
 
+#include <limits>
+
 namespace Ewoms {
 
 /*!
@@ -88,6 +90,16 @@ protected:
         ParentType::beginIteration_();
     }
 
+    /*!
+     * \copydoc FvBaseNewtonMethod::stepLengthRejected_
+     */
+    void stepLengthRejected_()
+    {
+        // the primary variables are switched again by the next update
+        numPriVarsSwitched_ = 0;
+        ParentType::stepLengthRejected_();
+    }
+
     /*!
      * \copydoc FvBaseNewtonMethod::endIteration_
      */
@@ -139,6 +151,11 @@ protected:
                       "A process did not succeed in adapting the primary variables");
 
         numPriVarsSwitched_ = comm.sum(numPriVarsSwitched_);
+
+        // the previous iterates cannot be combined with the current one if the meaning
+        // of the primary variables changed
+        if (numPriVarsSwitched_ > 0)
+            this->resetAcceleration_();
     }
 
     /*!
@@ -179,9 +196,30 @@ protected:
             nextValue[eqIdx] = currentValue[eqIdx] - delta;
         }
 
-        // switch the new primary variables to something which is physically meaningful
-        if (nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx))
+        // switch the new primary variables to something which is physically meaningful.
+        // this method is called concurrently for different degrees of freedom, but
+        // switches are rare, so an atomic increment of the counter is cheap.
+        if (nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx)) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
             ++ numPriVarsSwitched_;
+        }
+    }
+
+    /*!
+     * \copydoc FvBaseNewtonMethod::primaryVariablesChange_
+     */
+    Scalar primaryVariablesChange_(unsigned globalDofIdx,
+                                   const PrimaryVariables& nextValue,
+                                   const PrimaryVariables& currentValue) const
+    {
+        // if the primary variables were switched, the values of the switching
+        // variable cannot be compared
+        if (nextValue.primaryVarsMeaning() != currentValue.primaryVarsMeaning())
+            return std::numeric_limits<Scalar>::infinity();
+
+        return ParentType::primaryVariablesChange_(globalDofIdx, nextValue, currentValue);
     }
 
 private:
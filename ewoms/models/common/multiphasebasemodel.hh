@@ -195,7 +195,7 @@ public:
 
         storage = 0;
 
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView());
+        ThreadedEntityScheduler<GridView, /*codim=*/0> elemScheduler(this->gridView());
         OmpMutex addMutex;
 #ifdef _OPENMP
 #pragma omp parallel
@@ -205,13 +205,11 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(this->simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
             EqVector tmp;
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
+            elemScheduler.run([&](const Element& elem) {
                 if (elem.partitionType() != Dune::InteriorEntity)
-                    continue; // ignore ghost and overlap elements
+                    return; // ignore ghost and overlap elements
 
                 elemCtx.updateStencil(elem);
                 elemCtx.updateIntensiveQuantities(/*timeIdx=*/0);
@@ -230,11 +228,11 @@ public:
                                                                   phaseIdx);
                     tmp *= scv.volume()*intQuants.extrusionFactor();
 
-                    OmpMutex addLock(addMutex);
+                    ScopedLock addLock(addMutex);
                     storage += tmp;
                     addLock.unlock();
                 }
-            }
+            });
         }
 
         storage = this->gridView_.comm().sum(storage);
@@ -90,6 +90,10 @@ SET_BOOL_PROP(DiscreteFractureModel, UseTwoPointGradients, true);
 // of freedom. This is because the fracture properties (volume, permeability, etc) are
 // specific for each...
 SET_BOOL_PROP(DiscreteFractureModel, EnableIntensiveQuantityCache, false);
+
+// For the same reason, the storage term of a degree of freedom depends on the element
+// and thus cannot be cached either.
+SET_BOOL_PROP(DiscreteFractureModel, EnableStorageCache, false);
 } // namespace Properties
 
 /*!
@@ -124,6 +128,12 @@ public:
                       "The discrete fracture model does not work in conjunction "
                       "with intensive quantities caching");
         }
+
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache)) {
+            OPM_THROW(std::runtime_error,
+                      "The discrete fracture model does not work in conjunction "
+                      "with caching the storage term");
+        }
     }
 
     /*!
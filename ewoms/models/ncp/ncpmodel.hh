@@ -205,6 +205,7 @@ class NcpModel
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
     typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
     typedef typename GET_PROP_TYPE(TypeTag, Indices) Indices;
+    typedef typename GET_PROP_TYPE(TypeTag, PrimaryVariables) PrimaryVariables;
 
     enum { numPhases = FluidSystem::numPhases };
     enum { numComponents = FluidSystem::numComponents };
@@ -416,6 +417,34 @@ public:
         return FluidSystem::molarMass(compIdx);
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::isAdmissiblePrediction
+     */
+    bool isAdmissiblePrediction(unsigned globalDofIdx, const PrimaryVariables& pv) const
+    {
+        if (!ParentType::isAdmissiblePrediction(globalDofIdx, pv))
+            return false;
+
+        if (pv[pressure0Idx] <= 0.0)
+            return false;
+
+        Scalar sumSat = 0.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases - 1; ++phaseIdx) {
+            Scalar S = pv[saturation0Idx + phaseIdx];
+            if (S < 0.0 || S > 1.0)
+                return false;
+            sumSat += S;
+        }
+        if (sumSat > 1.0)
+            return false;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            if (pv[fugacity0Idx + compIdx] < 0.0)
+                return false;
+
+        return true;
+    }
+
     /*!
      * \brief Returns the smallest activity coefficient of a component for the
      *        most current solution at a vertex.
@@ -77,46 +77,39 @@ protected:
     friend ParentType;
     friend NewtonMethod<TypeTag>;
 
-    void preSolve_(const SolutionVector& currentSolution OPM_UNUSED,
-                   const GlobalEqVector& currentResidual)
+    /*!
+     * \copydoc NewtonMethod::residualError_
+     *
+     * The residuals of the NCP equations are not considered.
+     */
+    Scalar residualError_(const GlobalEqVector& residual) const
     {
         const auto& constraintsMap = this->model().linearizer().constraintsMap();
-        this->lastError_ = this->error_;
-
-        // calculate the error as the maximum weighted tolerance of
-        // the solution's residual
-        this->error_ = 0;
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
-            // do not consider auxiliary DOFs for the error
-            if (dofIdx >= this->model().numGridDof() || this->model().dofTotalVolume(dofIdx) <= 0.0)
+        const auto& model = this->model();
+        bool enableConstraints = this->enableConstraints_();
+        int numGridDof = static_cast<int>(model.numGridDof());
+        Scalar error = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(max: error)
+#endif
+        for (int i = 0; i < numGridDof; ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            if (model.dofTotalVolume(dofIdx) <= 0.0)
                 continue;
 
             // also do not consider DOFs which are constraint
-            if (this->enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0)
-                    continue;
-            }
+            if (enableConstraints && constraintsMap.count(dofIdx) > 0)
+                continue;
 
-            const auto& r = currentResidual[dofIdx];
+            const auto& r = residual[dofIdx];
             for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx) {
                 if (ncp0EqIdx <= eqIdx && eqIdx < Indices::ncp0EqIdx + numPhases)
                     continue;
-                this->error_ =
-                    std::max(std::abs(r[eqIdx]*this->model().eqWeight(dofIdx, eqIdx)),
-                             this->error_);
+                error = std::max(std::abs(r[eqIdx]*model.eqWeight(dofIdx, eqIdx)), error);
             }
         }
 
-        // take the other processes into account
-        this->error_ = this->comm_.max(this->error_);
-
-        // make sure that the error never grows beyond the maximum
-        // allowed one
-        if (this->error_ > EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError))
-            OPM_THROW(Opm::NumericalProblem,
-                      "Newton: Error " << this->error_
-                      << " is larger than maximum allowed error of "
-                      << EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError));
+        return error;
     }
 
     /*!
@@ -400,6 +400,33 @@ public:
         return FluidSystem::molarMass(compIdx);
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::canExtrapolate
+     */
+    bool canExtrapolate(const PrimaryVariables& pv1, const PrimaryVariables& pv2) const
+    { return pv1.phasePresence() == pv2.phasePresence(); }
+
+    /*!
+     * \copydoc FvBaseDiscretization::isAdmissiblePrediction
+     */
+    bool isAdmissiblePrediction(unsigned globalDofIdx, const PrimaryVariables& pv) const
+    {
+        if (!ParentType::isAdmissiblePrediction(globalDofIdx, pv))
+            return false;
+
+        if (pv[Indices::pressure0Idx] <= 0.0)
+            return false;
+
+        // the switching variables are either saturations or mole fractions
+        for (unsigned i = 0; i < numComponents - 1; ++i) {
+            Scalar x = pv[Indices::switch0Idx + i];
+            if (x < 0.0 || x > 1.0)
+                return false;
+        }
+
+        return true;
+    }
+
     /*!
      * \copydoc FvBaseDiscretization::advanceTimeLevel
      */
@@ -506,6 +533,11 @@ public:
                     priVars.assignNaive(intQuants.fluidState());
 
                     if (oldPhasePresence != priVars.phasePresence()) {
+                        // the cached intensive quantities refer to the old phase state
+                        this->setIntensiveQuantitiesCacheEntryValidity(globalIdx,
+                                                                       /*timeIdx=*/0,
+                                                                       /*valid=*/false);
+
                         if (verbosity_ > 1)
                             printSwitchedPhases_(elemCtx,
                                                  dofIdx,
@@ -119,6 +119,11 @@ protected:
     {
         ParentType::endIteration_(uCurrentIter, uLastIter);
         this->problem().model().switchPrimaryVars_();
+
+        // the previous iterates cannot be combined with the current one if the meaning
+        // of the primary variables changed
+        if (this->problem().model().switched())
+            this->resetAcceleration_();
     }
 
     void clampValue_(Scalar& val, Scalar minVal, Scalar maxVal) const
@@ -42,11 +42,20 @@
 
 #include <dune/istl/istlexception.hh>
 #include <dune/common/classname.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
 #include <dune/common/version.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <unistd.h>
 
@@ -144,6 +153,63 @@ NEW_PROP_TAG(NewtonTargetIterations);
 //! Number of maximum iterations for the Newton method.
 NEW_PROP_TAG(NewtonMaxIterations);
 
+/*!
+ * \brief Specifies whether the Newton update should be damped by a backtracking line
+ *        search.
+ *
+ * If enabled, the update is halved until the weighted residual is sufficiently
+ * reduced (Armijo criterion). This costs an additional evaluation of the residual per
+ * step length which is tried. Before each of these evaluations, the problem's
+ * beginIteration() method is called for the trial solution.
+ */
+NEW_PROP_TAG(NewtonEnableLineSearch);
+
+//! The maximum number of times the update is halved by the line search
+NEW_PROP_TAG(NewtonLineSearchMaxSteps);
+
+//! The fraction of the reduction of the residual predicted by the linearization which
+//! must be achieved for a step length to be accepted by the line search
+NEW_PROP_TAG(NewtonLineSearchArmijoParameter);
+
+/*!
+ * \brief Specifies whether the tolerance of the linear solver should be adapted to the
+ *        progress of the Newton method.
+ *
+ * If enabled, the reduction of the residual required by the linear solver is
+ * determined by the forcing terms of Eisenstat and Walker, i.e., the linear systems are
+ * solved less accurately as long as the non-linear residual is large.
+ */
+NEW_PROP_TAG(NewtonAdaptiveLinearTolerance);
+
+//! The largest reduction of the residual which is required by the linear solver if its
+//! tolerance is adapted by the Newton method
+NEW_PROP_TAG(NewtonMaxLinearTolerance);
+
+/*!
+ * \brief The number of previous iterates which are used to accelerate the Newton
+ *        method.
+ *
+ * If this is larger than zero, the updates of the Newton method are combined with the
+ * ones of the previous iterations using Anderson acceleration. This may help if the
+ * Newton method oscillates instead of converging. 0 disables the acceleration.
+ */
+NEW_PROP_TAG(NewtonAndersonDepth);
+
+/*!
+ * \brief Specifies whether the Jacobian matrix may be reused by subsequent Newton
+ *        iterations (modified Newton method).
+ *
+ * If enabled, the Jacobian matrix and the preconditioner of the previous iteration are
+ * reused and only the residual is evaluated as long as the last iteration reduced the
+ * error by at least the factor given by the NewtonFrozenJacobianMaxContraction
+ * property.
+ */
+NEW_PROP_TAG(NewtonFrozenJacobian);
+
+//! The largest ratio of the errors of two consecutive Newton iterations for which the
+//! Jacobian matrix is reused
+NEW_PROP_TAG(NewtonFrozenJacobianMaxContraction);
+
 // set default values for the properties
 SET_TYPE_PROP(NewtonMethod, NewtonMethod, Ewoms::NewtonMethod<TypeTag>);
 SET_TYPE_PROP(NewtonMethod, NewtonConvergenceWriter, Ewoms::NullConvergenceWriter<TypeTag>);
@@ -155,10 +221,51 @@ SET_SCALAR_PROP(NewtonMethod, NewtonRawTolerance, 1e-8);
 SET_SCALAR_PROP(NewtonMethod, NewtonMaxError, 1e100);
 SET_INT_PROP(NewtonMethod, NewtonTargetIterations, 10);
 SET_INT_PROP(NewtonMethod, NewtonMaxIterations, 18);
+SET_BOOL_PROP(NewtonMethod, NewtonEnableLineSearch, false);
+SET_INT_PROP(NewtonMethod, NewtonLineSearchMaxSteps, 4);
+SET_SCALAR_PROP(NewtonMethod, NewtonLineSearchArmijoParameter, 1e-4);
+SET_BOOL_PROP(NewtonMethod, NewtonAdaptiveLinearTolerance, false);
+SET_SCALAR_PROP(NewtonMethod, NewtonMaxLinearTolerance, 0.1);
+SET_INT_PROP(NewtonMethod, NewtonAndersonDepth, 0);
+SET_BOOL_PROP(NewtonMethod, NewtonFrozenJacobian, false);
+SET_SCALAR_PROP(NewtonMethod, NewtonFrozenJacobianMaxContraction, 0.5);
 } // namespace Properties
 } // namespace Ewoms
 
 namespace Ewoms {
+namespace detail {
+// determines whether a linear solver backend allows to change its tolerance
+template <class LinearSolverBackend, class Scalar>
+class LinearSolverHasSetTolerance
+{
+    template <class T>
+    static auto test_(int)
+        -> decltype(std::declval<T&>().setTolerance(std::declval<Scalar>()), std::true_type());
+
+    template <class T>
+    static std::false_type test_(...);
+
+public:
+    static const bool value = decltype(test_<LinearSolverBackend>(0))::value;
+};
+
+// determines whether a linear solver backend can reuse the preconditioner of the
+// previous matrix
+template <class LinearSolverBackend>
+class LinearSolverHasPrepareUnchangedMatrix
+{
+    template <class T>
+    static auto test_(int)
+        -> decltype(std::declval<T&>().prepareUnchangedMatrix(), std::true_type());
+
+    template <class T>
+    static std::false_type test_(...);
+
+public:
+    static const bool value = decltype(test_<LinearSolverBackend>(0))::value;
+};
+} // namespace detail
+
 /*!
  * \ingroup Newton
  * \brief The multi-dimensional Newton method.
@@ -199,8 +306,25 @@ public:
         lastError_ = 1e100;
         error_ = 1e100;
         tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonRawTolerance);
+        lastLinearTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance);
+        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonAdaptiveLinearTolerance)
+            && !linearSolverHasSetTolerance_())
+            OPM_THROW(std::runtime_error,
+                      "The tolerance of the linear solver cannot be adapted because the "
+                      "linear solver backend does not provide a setTolerance() method");
 
         numIterations_ = 0;
+
+        andersonHistorySize_ = 0;
+        andersonNextSlot_ = 0;
+        andersonHasLast_ = false;
+
+        applyingLineSearchStep_ = false;
+
+        numFrozenIterations_ = 0;
+        errorBeforeLastIteration_ = 0.0;
+        haveJacobian_ = false;
+        jacobianFrozen_ = false;
     }
 
     /*!
@@ -229,6 +353,31 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxError,
                              "The maximum error tolerated by the Newton "
                              "method to which does not cause an abort");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonEnableLineSearch,
+                             "Damp the Newton update using a backtracking line "
+                             "search on the weighted residual");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonLineSearchMaxSteps,
+                             "The maximum number of times the Newton update is "
+                             "halved by the line search");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonLineSearchArmijoParameter,
+                             "The fraction of the predicted reduction of the "
+                             "residual which must be achieved for a step length "
+                             "to be accepted by the line search");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonAdaptiveLinearTolerance,
+                             "Adapt the tolerance of the linear solver to the "
+                             "reduction of the error of the Newton method");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance,
+                             "The largest residual reduction required by the linear "
+                             "solver if its tolerance is adapted");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonAndersonDepth,
+                             "The number of previous iterates used to accelerate "
+                             "the Newton method (0 disables Anderson acceleration)");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonFrozenJacobian,
+                             "Reuse the Jacobian matrix of previous Newton iterations "
+                             "as long as the error decreases sufficiently");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonFrozenJacobianMaxContraction,
+                             "The largest ratio of the errors of two consecutive Newton "
+                             "iterations for which the Jacobian matrix is reused");
     }
 
     /*!
@@ -392,10 +541,41 @@ public:
 
                 solveTimer_.start();
                 solutionUpdate = 0;
-                linearSolver_.prepareMatrix(M);
+                if (EWOMS_GET_PARAM(TypeTag, bool, NewtonAdaptiveLinearTolerance))
+                    setLinearSolverTolerance_(asImp_().linearTolerance_(),
+                                              std::integral_constant<bool,
+                                                                     linearSolverHasSetTolerance_()>());
+                if (jacobianFrozen_)
+                    prepareUnchangedMatrix_(M,
+                                            std::integral_constant<bool,
+                                                                   linearSolverHasPrepareUnchangedMatrix_()>());
+                else
+                    linearSolver_.prepareMatrix(M);
                 bool converged = linearSolver_.solve(solutionUpdate);
                 solveTimer_.stop();
 
+                if (!converged && jacobianFrozen_) {
+                    // the Jacobian of a previous iteration was not good enough for the
+                    // linear solver. try again with the current one.
+                    if (asImp_().verbose_())
+                        std::cout << "Newton: Linear solver did not converge for frozen "
+                                  << "Jacobian. Relinearizing.\n" << std::flush;
+
+                    linearizeTimer_.start();
+                    linearizer.linearize();
+                    haveJacobian_ = true;
+                    jacobianFrozen_ = false;
+                    --numFrozenIterations_;
+                    linearizeTimer_.stop();
+
+                    solveTimer_.start();
+                    linearSolver_.prepareRhs(M, b);
+                    solutionUpdate = 0;
+                    linearSolver_.prepareMatrix(M);
+                    converged = linearSolver_.solve(solutionUpdate);
+                    solveTimer_.stop();
+                }
+
                 if (!converged) {
                     solveTimer_.stop();
                     if (asImp_().verbose_())
@@ -422,7 +602,12 @@ public:
                                     currentSolution,
                                     b,
                                     solutionUpdate);
-                asImp_().update_(nextSolution, currentSolution, solutionUpdate, b);
+                if (EWOMS_GET_PARAM(TypeTag, int, NewtonAndersonDepth) > 0)
+                    asImp_().accelerateUpdate_(currentSolution, solutionUpdate);
+                if (EWOMS_GET_PARAM(TypeTag, bool, NewtonEnableLineSearch))
+                    asImp_().lineSearch_(nextSolution, currentSolution, solutionUpdate, b);
+                else
+                    asImp_().update_(nextSolution, currentSolution, solutionUpdate, b);
                 updateTimer_.stop();
 
                 if (asImp_().verbose_() && isatty(fileno(stdout)))
@@ -585,6 +770,13 @@ protected:
     void begin_(const SolutionVector& u  OPM_UNUSED)
     {
         numIterations_ = 0;
+        resetAcceleration_();
+
+        // the Jacobian of the previous time step is not reused because the storage
+        // term depends on the time step size
+        haveJacobian_ = false;
+        jacobianFrozen_ = false;
+        numFrozenIterations_ = 0;
 
         if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence))
             convergenceWriter_.beginTimeStep();
@@ -601,34 +793,49 @@ protected:
 
     /*!
      * \brief Linearize the global non-linear system of equations.
+     *
+     * If reusing the Jacobian matrix is enabled and the error of the last iteration is
+     * smaller than the one of the iteration before by at least the factor given by
+     * NewtonFrozenJacobianMaxContraction, only the residual is evaluated and the
+     * Jacobian matrix of the previous iteration is kept.
      */
     void linearize_()
-    { model().linearizer().linearize(); }
+    {
+        Linearizer& linearizer = model().linearizer();
+
+        // at this point, error_ is the error of the last iteration. (it is only
+        // meaningful after the first iteration.)
+        Scalar olderError = errorBeforeLastIteration_;
+        errorBeforeLastIteration_ = error_;
+
+        jacobianFrozen_ = false;
+        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonFrozenJacobian)
+            && haveJacobian_
+            && numIterations_ > 1)
+        {
+            Scalar maxContraction =
+                EWOMS_GET_PARAM(TypeTag, Scalar, NewtonFrozenJacobianMaxContraction);
+            if (error_ <= maxContraction*olderError) {
+                linearizer.linearizeResidual();
+                jacobianFrozen_ = true;
+                ++numFrozenIterations_;
+                endIterMsg() << ", frozen Jacobian";
+                return;
+            }
+        }
+
+        linearizer.linearize();
+        haveJacobian_ = true;
+    }
 
     void preSolve_(const SolutionVector& currentSolution  OPM_UNUSED,
                    const GlobalEqVector& currentResidual)
     {
-        const auto& constraintsMap = model().linearizer().constraintsMap();
         lastError_ = error_;
 
         // calculate the error as the maximum weighted tolerance of
         // the solution's residual
-        error_ = 0;
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
-            // do not consider auxiliary DOFs for the error
-            if (dofIdx >= model().numGridDof() || model().dofTotalVolume(dofIdx) <= 0.0)
-                continue;
-
-            // also do not consider DOFs which are constraint
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0)
-                    continue;
-            }
-
-            const auto& r = currentResidual[dofIdx];
-            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
-                error_ = Opm::max(std::abs(r[eqIdx] * model().eqWeight(dofIdx, eqIdx)), error_);
-        }
+        error_ = asImp_().residualError_(currentResidual);
 
         // take the other processes into account
         error_ = comm_.max(error_);
@@ -642,6 +849,77 @@ protected:
                       << EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError));
     }
 
+    /*!
+     * \brief Returns the maximum weighted residual of the degrees of freedom of the
+     *        local process.
+     *
+     * Auxiliary and constraint degrees of freedom are not considered.
+     */
+    Scalar residualError_(const GlobalEqVector& residual) const
+    {
+        const auto& constraintsMap = model().linearizer().constraintsMap();
+        const auto& model = this->model();
+        bool enableConstraints = enableConstraints_();
+        int numGridDof = static_cast<int>(model.numGridDof());
+        Scalar error = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(max: error)
+#endif
+        for (int i = 0; i < numGridDof; ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            if (model.dofTotalVolume(dofIdx) <= 0.0)
+                continue;
+
+            // also do not consider DOFs which are constraint
+            if (enableConstraints && constraintsMap.count(dofIdx) > 0)
+                continue;
+
+            const auto& r = residual[dofIdx];
+            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
+                error = std::max(std::abs(r[eqIdx] * model.eqWeight(dofIdx, eqIdx)), error);
+        }
+
+        return error;
+    }
+
+    /*!
+     * \brief Returns the reduction of the residual which is required by the linear
+     *        solver for the current iteration.
+     *
+     * This implements choice 2 of the forcing terms of Eisenstat and Walker (1996), i.e.,
+     * \f[ \eta_k = \gamma \left( \frac{\|r(u^k)\|}{\|r(u^{k-1})\|} \right)^\alpha \f]
+     * with \f$\gamma = 0.9\f$ and \f$\alpha = 2\f$, where the weighted maximum norm of
+     * the residual is used. The tolerance is safeguarded against decreasing too fast and
+     * against oversolving once the error gets close to the tolerance of the Newton
+     * method. It never exceeds the value of the NewtonMaxLinearTolerance parameter.
+     */
+    Scalar linearTolerance_()
+    {
+        const Scalar gamma = 0.9;
+        const Scalar alpha = 2.0;
+        Scalar maxTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance);
+
+        Scalar eta = maxTolerance;
+        if (numIterations_ > 0 && lastError_ > 0.0) {
+            eta = gamma*std::pow(error_/lastError_, alpha);
+
+            Scalar etaSafeguard = gamma*std::pow(lastLinearTolerance_, alpha);
+            if (etaSafeguard > 0.1)
+                eta = std::max(eta, etaSafeguard);
+        }
+
+        // do not solve the linear system more accurately than needed to reach the
+        // tolerance of the Newton method
+        if (error_ > 0.0)
+            eta = std::max(eta, 0.5*tolerance()/error_);
+
+        eta = std::min(eta, maxTolerance);
+        lastLinearTolerance_ = eta;
+
+        endIterMsg() << ", linear tolerance=" << eta;
+        return eta;
+    }
+
     /*!
      * \brief Update the error of the solution given the previous
      *        iteration.
@@ -683,47 +961,454 @@ protected:
         const auto& constraintsMap = model().linearizer().constraintsMap();
 
         // first, write out the current solution to make convergence
-        // analysis possible
-        asImp_().writeConvergence_(currentSolution, solutionUpdate);
-
-        // make sure not to swallow non-finite values at this point
-        if (!std::isfinite(solutionUpdate.one_norm()))
-            OPM_THROW(Opm::NumericalProblem, "Non-finite update!");
+        // analysis possible. (the line search only writes it for the step length which
+        // it accepts.)
+        if (!applyingLineSearchStep_)
+            asImp_().writeConvergence_(currentSolution, solutionUpdate);
+
+        // update the primary variables of all DOFs of the grid in a single pass. this
+        // pass also makes sure not to swallow non-finite values: the primary variables
+        // of DOFs with a non-finite update are left alone and an exception is thrown
+        // after the loop. (exceptions must not leave an OpenMP region.)
+        bool enableConstraints = enableConstraints_();
+        int numGridDof = static_cast<int>(model().numGridDof());
+        int numNonFinite = 0;
+        int numFailed = 0;
+        std::string failureMsg;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+: numNonFinite, numFailed)
+#endif
+        for (int i = 0; i < numGridDof; ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            const auto& update = solutionUpdate[dofIdx];
+
+            bool isFinite = true;
+            for (unsigned eqIdx = 0; eqIdx < update.size(); ++eqIdx)
+                isFinite = isFinite && std::isfinite(update[eqIdx]);
+            if (!isFinite) {
+                ++ numNonFinite;
+                continue;
+            }
 
-        size_t numGridDof = model().numGridDof();
-        for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0) {
-                    const auto& constraints = constraintsMap.at(dofIdx);
+            try {
+                if (enableConstraints && constraintsMap.count(dofIdx) > 0)
                     asImp_().updateConstraintDof_(dofIdx,
                                                   nextSolution[dofIdx],
-                                                  constraints);
-                }
+                                                  constraintsMap.at(dofIdx));
                 else
                     asImp_().updatePrimaryVariables_(dofIdx,
                                                      nextSolution[dofIdx],
                                                      currentSolution[dofIdx],
-                                                     solutionUpdate[dofIdx],
+                                                     update,
                                                      currentResidual[dofIdx]);
             }
-            else
-                asImp_().updatePrimaryVariables_(dofIdx,
-                                                 nextSolution[dofIdx],
-                                                 currentSolution[dofIdx],
-                                                 solutionUpdate[dofIdx],
-                                                 currentResidual[dofIdx]);
+            catch (const std::exception& e) {
+                ++ numFailed;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                failureMsg = e.what();
+            }
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2, 5)
+            catch (const Dune::Exception& e) {
+                ++ numFailed;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                failureMsg = e.what();
+            }
+#endif
+            catch (...) {
+                // exceptions must not escape the parallel region
+                ++ numFailed;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                failureMsg = "unknown exception";
+            }
         }
 
+        if (numNonFinite > 0)
+            OPM_THROW(Opm::NumericalProblem, "Non-finite update!");
+        if (numFailed > 0)
+            OPM_THROW(Opm::NumericalProblem,
+                      "Updating the primary variables of " << numFailed
+                      << " degrees of freedom failed: " << failureMsg);
+
         // update the DOFs of the auxiliary equations
         size_t numDof = model().numTotalDof();
-        for (size_t dofIdx = numGridDof; dofIdx < numDof; ++dofIdx) {
+        for (size_t dofIdx = static_cast<size_t>(numGridDof); dofIdx < numDof; ++dofIdx) {
             nextSolution[dofIdx] = currentSolution[dofIdx];
             nextSolution[dofIdx] -= solutionUpdate[dofIdx];
         }
     }
 
+    /*!
+     * \brief Update the current solution with a delta vector which is damped by a
+     *        backtracking line search.
+     *
+     * The update is scaled by a step length \f$\lambda\f$, i.e., \f[ u^{k+1} = u^k -
+     * \lambda \Delta u^k \f] is set. Starting with the step length returned by
+     * maxStepLength_(), \f$\lambda\f$ is halved until the weighted residual of the
+     * updated solution satisfies the Armijo criterion \f$\|r(u^{k+1})\| \leq (1 - c
+     * \lambda) \|r(u^k)\|\f$ or until the maximum number of halvings is reached. In
+     * the latter case, the evaluated step length with the smallest residual is taken if
+     * it reduces the residual at all. Otherwise the Newton method fails. Each step
+     * length is applied using update_() and its residual is evaluated without
+     * linearizing the system after calling prepareTrialSolution_(). The convergence
+     * output is only written once for the accepted step length.
+     *
+     * \param nextSolution The solution vector after the current iteration
+     * \param currentSolution The solution vector after the last iteration
+     * \param solutionUpdate The delta vector as calculated by solving the linear system
+     *                       of equations
+     * \param currentResidual The residual vector of the current Newton-Raphson
+     *                        iteraton. It is overwritten by the residuals of the step
+     *                        lengths which are tried.
+     */
+    void lineSearch_(SolutionVector& nextSolution,
+                     const SolutionVector& currentSolution,
+                     const GlobalEqVector& solutionUpdate,
+                     GlobalEqVector& currentResidual)
+    {
+        int maxSteps = EWOMS_GET_PARAM(TypeTag, int, NewtonLineSearchMaxSteps);
+        Scalar armijoParam = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonLineSearchArmijoParameter);
+
+        // the residual vector of the linearizer is overwritten when evaluating the
+        // residuals of the trial solutions
+        lineSearchResidual_ = currentResidual;
+
+        Scalar stepLength = std::min<Scalar>(1.0, asImp_().maxStepLength_(currentSolution,
+                                                                        solutionUpdate));
+        stepLength = comm_.min(stepLength);
+
+        Scalar bestStepLength = 0.0;
+        Scalar bestError = error_;
+        for (int stepIdx = 0; stepIdx <= maxSteps; ++stepIdx) {
+            if (stepIdx > 0)
+                asImp_().stepLengthRejected_();
+
+            Scalar trialError;
+            bool succeeded = evalLineSearchStep_(nextSolution,
+                                                 currentSolution,
+                                                 solutionUpdate,
+                                                 currentResidual,
+                                                 stepLength,
+                                                 trialError);
+
+            if (succeeded && trialError <= (1.0 - armijoParam*stepLength)*error_) {
+                writeLineSearchConvergence_(currentSolution, solutionUpdate, stepLength);
+                endIterMsg() << ", step length=" << stepLength;
+                return;
+            }
+
+            if (succeeded && trialError < bestError) {
+                bestStepLength = stepLength;
+                bestError = trialError;
+            }
+
+            stepLength /= 2;
+        }
+
+        // none of the step lengths satisfies the Armijo criterion. fall back to the one
+        // which reduces the error the most.
+        if (bestStepLength <= 0.0)
+            OPM_THROW(Opm::NumericalProblem,
+                      "Line search: None of the step lengths reduces the error");
+
+        asImp_().stepLengthRejected_();
+        applyLineSearchStep_(nextSolution, currentSolution, solutionUpdate, bestStepLength);
+        writeLineSearchConvergence_(currentSolution, solutionUpdate, bestStepLength);
+
+        endIterMsg() << ", step length=" << bestStepLength;
+    }
+
+    // apply the Newton update scaled by a step length to the current solution. this
+    // does not write any convergence output.
+    void applyLineSearchStep_(SolutionVector& nextSolution,
+                              const SolutionVector& currentSolution,
+                              const GlobalEqVector& solutionUpdate,
+                              Scalar stepLength)
+    {
+        applyingLineSearchStep_ = true;
+        try {
+            if (stepLength < 1.0) {
+                lineSearchUpdate_ = solutionUpdate;
+                lineSearchUpdate_ *= stepLength;
+                asImp_().update_(nextSolution, currentSolution, lineSearchUpdate_, lineSearchResidual_);
+            }
+            else
+                asImp_().update_(nextSolution, currentSolution, solutionUpdate, lineSearchResidual_);
+        }
+        catch (...) {
+            applyingLineSearchStep_ = false;
+            throw;
+        }
+        applyingLineSearchStep_ = false;
+    }
+
+    // write the convergence output for the step length accepted by the line search. the
+    // step length must be the one which was applied last.
+    void writeLineSearchConvergence_(const SolutionVector& currentSolution,
+                                     const GlobalEqVector& solutionUpdate,
+                                     Scalar stepLength)
+    {
+        if (stepLength < 1.0)
+            asImp_().writeConvergence_(currentSolution, lineSearchUpdate_);
+        else
+            asImp_().writeConvergence_(currentSolution, solutionUpdate);
+    }
+
+    // apply a step length of the line search and evaluate the error of the resulting
+    // solution. a trial solution for which the residual cannot be evaluated is treated
+    // like one which does not reduce the error sufficiently.
+    bool evalLineSearchStep_(SolutionVector& nextSolution,
+                             const SolutionVector& currentSolution,
+                             const GlobalEqVector& solutionUpdate,
+                             GlobalEqVector& currentResidual,
+                             Scalar stepLength,
+                             Scalar& trialError)
+    {
+        Linearizer& linearizer = model().linearizer();
+
+        applyLineSearchStep_(nextSolution, currentSolution, solutionUpdate, stepLength);
+
+        int succeeded = 1;
+        trialError = 0.0;
+        try {
+            asImp_().prepareTrialSolution_();
+            linearizer.linearizeResidual();
+            linearSolver_.prepareRhs(linearizer.matrix(), currentResidual);
+            trialError = asImp_().residualError_(currentResidual);
+        }
+        catch (const Dune::Exception&) {
+            succeeded = 0;
+        }
+        catch (const Opm::NumericalProblem&) {
+            succeeded = 0;
+        }
+        succeeded = comm_.min(succeeded);
+        trialError = comm_.max(trialError);
+
+        return succeeded != 0;
+    }
+
+    /*!
+     * \brief Combine the update of the current iteration with the ones of the previous
+     *        iterations using Anderson acceleration.
+     *
+     * The Newton method is treated as the fixed point iteration \f$u \mapsto g(u) = u -
+     * \Delta u\f$ with the residual \f$f(u) = g(u) - u\f$. The next iterate is
+     * \f[ u^{k+1} = g(u^k) - \sum_i \gamma_i \left(g(u^{i+1}) - g(u^i)\right)\f]
+     * where the coefficients \f$\gamma_i\f$ minimize \f$\|f(u^k) - \sum_i \gamma_i
+     * (f(u^{i+1}) - f(u^i))\|\f$ for the last iterates. The norm is weighted by the
+     * weights of the primary variables. The accelerated update is returned in
+     * solutionUpdate, i.e., it is subsequently applied using update_() like an
+     * ordinary Newton update. The degrees of freedom of the auxiliary equations are not
+     * accelerated.
+     *
+     * The history must be discarded using resetAcceleration_() if the meaning of the
+     * primary variables changes.
+     */
+    void accelerateUpdate_(const SolutionVector& currentSolution,
+                           GlobalEqVector& solutionUpdate)
+    {
+        unsigned depth = static_cast<unsigned>(EWOMS_GET_PARAM(TypeTag, int, NewtonAndersonDepth));
+        int numGridDof = static_cast<int>(model().numGridDof());
+
+        if (andersonDeltaF_.size() != depth) {
+            andersonDeltaF_.resize(depth);
+            andersonDeltaG_.resize(depth);
+            resetAcceleration_();
+        }
+
+        // add the differences to the last iterate to the history
+        if (andersonHasLast_) {
+            GlobalEqVector& deltaF = andersonDeltaF_[andersonNextSlot_];
+            GlobalEqVector& deltaG = andersonDeltaG_[andersonNextSlot_];
+            deltaF.resize(static_cast<size_t>(numGridDof));
+            deltaG.resize(static_cast<size_t>(numGridDof));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+                const auto& u = currentSolution[static_cast<unsigned>(dofIdx)];
+                const auto& du = solutionUpdate[static_cast<unsigned>(dofIdx)];
+                const auto& lastF = andersonLastF_[static_cast<unsigned>(dofIdx)];
+                const auto& lastG = andersonLastG_[static_cast<unsigned>(dofIdx)];
+                auto& dF = deltaF[static_cast<unsigned>(dofIdx)];
+                auto& dG = deltaG[static_cast<unsigned>(dofIdx)];
+                for (unsigned pvIdx = 0; pvIdx < du.size(); ++pvIdx) {
+                    dF[pvIdx] = - du[pvIdx] - lastF[pvIdx];
+                    dG[pvIdx] = u[pvIdx] - du[pvIdx] - lastG[pvIdx];
+                }
+            }
+
+            andersonNextSlot_ = (andersonNextSlot_ + 1) % depth;
+            andersonHistorySize_ = std::min(andersonHistorySize_ + 1, depth);
+        }
+
+        // remember the current iterate
+        andersonLastF_.resize(static_cast<size_t>(numGridDof));
+        andersonLastG_.resize(static_cast<size_t>(numGridDof));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            const auto& u = currentSolution[static_cast<unsigned>(dofIdx)];
+            const auto& du = solutionUpdate[static_cast<unsigned>(dofIdx)];
+            auto& lastF = andersonLastF_[static_cast<unsigned>(dofIdx)];
+            auto& lastG = andersonLastG_[static_cast<unsigned>(dofIdx)];
+            for (unsigned pvIdx = 0; pvIdx < du.size(); ++pvIdx) {
+                lastF[pvIdx] = - du[pvIdx];
+                lastG[pvIdx] = u[pvIdx] - du[pvIdx];
+            }
+        }
+        andersonHasLast_ = true;
+
+        unsigned m = andersonHistorySize_;
+        if (m == 0)
+            return;
+
+        // assemble the normal equations of the least squares problem. the scalar
+        // products are computed for all processes at once.
+        std::vector<Scalar> products(m*m + m, 0.0);
+        for (unsigned i = 0; i < m; ++i) {
+            for (unsigned j = 0; j <= i; ++j)
+                products[i*m + j] = andersonProduct_(andersonDeltaF_[i], andersonDeltaF_[j]);
+            products[m*m + i] = andersonProduct_(andersonDeltaF_[i], andersonLastF_);
+        }
+        comm_.sum(products.data(), static_cast<int>(products.size()));
+
+        Dune::DynamicMatrix<Scalar> A(m, m);
+        Dune::DynamicVector<Scalar> b(m);
+        Dune::DynamicVector<Scalar> gamma(m);
+        for (unsigned i = 0; i < m; ++i) {
+            for (unsigned j = 0; j <= i; ++j)
+                A[i][j] = A[j][i] = products[i*m + j];
+            // slightly regularize the system because the differences of the
+            // residuals tend to be almost linearly dependent
+            A[i][i] *= 1.0 + 1e-10;
+            b[i] = products[m*m + i];
+        }
+
+        bool solved = true;
+        try {
+            A.solve(gamma, b);
+            for (unsigned i = 0; i < m; ++i)
+                solved = solved && std::isfinite(gamma[i]);
+        }
+        catch (const Dune::FMatrixError&) {
+            solved = false;
+        }
+
+        if (!solved) {
+            // use the plain Newton update and start over
+            resetAcceleration_();
+            return;
+        }
+
+        // u^{k+1} = g(u^k) - sum_i gamma_i deltaG_i, i.e., the update becomes
+        // du + sum_i gamma_i deltaG_i
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            auto& du = solutionUpdate[static_cast<unsigned>(dofIdx)];
+            for (unsigned i = 0; i < m; ++i) {
+                const auto& dG = andersonDeltaG_[i][static_cast<unsigned>(dofIdx)];
+                for (unsigned pvIdx = 0; pvIdx < du.size(); ++pvIdx)
+                    du[pvIdx] += gamma[i]*dG[pvIdx];
+            }
+        }
+
+        endIterMsg() << ", acceleration depth=" << m;
+    }
+
+    /*!
+     * \brief Discard the previous iterates which are used by Anderson acceleration.
+     *
+     * Models must call this if the meaning of the primary variables changes.
+     */
+    void resetAcceleration_()
+    {
+        andersonHasLast_ = false;
+        andersonHistorySize_ = 0;
+        andersonNextSlot_ = 0;
+    }
+
+    /*!
+     * \brief Returns the process-local scalar product of two vectors of the grid degrees
+     *        of freedom which is weighted by the weights of the primary variables.
+     *
+     * Like for the residual error, only the degrees of freedom which are owned by the
+     * process are considered, so that overlap and ghost DOFs are not counted multiple
+     * times once the products are summed over all processes.
+     */
+    Scalar andersonProduct_(const GlobalEqVector& a, const GlobalEqVector& b) const
+    {
+        const auto& model = this->model();
+        int numGridDof = static_cast<int>(model.numGridDof());
+        Scalar result = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+: result)
+#endif
+        for (int i = 0; i < numGridDof; ++i) {
+            unsigned dofIdx = static_cast<unsigned>(i);
+            if (model.dofTotalVolume(dofIdx) <= 0.0)
+                continue;
+
+            const auto& aa = a[dofIdx];
+            const auto& bb = b[dofIdx];
+            for (unsigned pvIdx = 0; pvIdx < aa.size(); ++pvIdx) {
+                Scalar w = model.primaryVarWeight(dofIdx, pvIdx);
+                result += w*w*aa[pvIdx]*bb[pvIdx];
+            }
+        }
+
+        return result;
+    }
+
+    /*!
+     * \brief Returns the maximum length of the Newton step which is considered by the
+     *        line search.
+     *
+     * This allows models to limit the update based on physical considerations, e.g. to
+     * keep saturations or pressures within a range where the linearization is
+     * meaningful. The default is to start with the full Newton step.
+     */
+    Scalar maxStepLength_(const SolutionVector& currentSolution OPM_UNUSED,
+                          const GlobalEqVector& solutionUpdate OPM_UNUSED) const
+    { return 1.0; }
+
+    /*!
+     * \brief Called by the line search if the solution was updated using a step length
+     *        which has been rejected.
+     *
+     * The solution is subsequently updated using update_() and a shorter step length,
+     * i.e., implementations must revert any state which depends on the rejected
+     * update.
+     */
+    void stepLengthRejected_()
+    { }
+
+    /*!
+     * \brief Called by the line search before the residual of a trial solution is
+     *        evaluated.
+     *
+     * The state which the problem and the auxiliary modules derive from the solution
+     * at the beginning of each iteration must be updated here, because it is used by
+     * the residual. By default, the problem's beginIteration() method is called, i.e.,
+     * with the line search enabled, it may be called several times per iteration.
+     */
+    void prepareTrialSolution_()
+    { problem().beginIteration(); }
+
     /*!
      * \brief Update the primary variables for a degree of freedom which is constraint.
+     *
+     * This method is called concurrently for different degrees of freedom if OpenMP is
+     * enabled.
      */
     void updateConstraintDof_(unsigned globalDofIdx  OPM_UNUSED,
                               PrimaryVariables& nextValue,
@@ -732,6 +1417,10 @@ protected:
 
     /*!
      * \brief Update a single primary variables object.
+     *
+     * This method is called concurrently for different degrees of freedom if OpenMP is
+     * enabled, i.e., overloads must not modify any state which is shared between
+     * degrees of freedom without synchronization.
      */
     void updatePrimaryVariables_(unsigned globalDofIdx  OPM_UNUSED,
                                  PrimaryVariables& nextValue,
@@ -792,7 +1481,9 @@ protected:
             // do more iterations
             return false;
         }
-        else if (asImp_().numIterations() >= asImp_().maxIterations_()) {
+        else if (asImp_().numIterations() - 0.5*numFrozenIterations_ >= asImp_().maxIterations_()) {
+            // iterations which reuse the Jacobian matrix count as half an iteration
+            // because they are cheaper and converge more slowly
             // we have exceeded the allowed number of steps.  If the
             // error was reduced by a factor of at least 4,
             // in the last iterations we proceed even if we are above
@@ -851,10 +1542,17 @@ protected:
     Scalar error_;
     Scalar lastError_;
     Scalar tolerance_;
+    Scalar lastLinearTolerance_;
 
     // actual number of iterations done so far
     int numIterations_;
 
+    // the state of the modified Newton method
+    int numFrozenIterations_;
+    Scalar errorBeforeLastIteration_;
+    bool haveJacobian_;
+    bool jacobianFrozen_;
+
     // the linear solver
     LinearSolverBackend linearSolver_;
 
@@ -866,7 +1564,46 @@ protected:
     // method to disk
     ConvergenceWriter convergenceWriter_;
 
+    // temporary vectors of the line search
+    GlobalEqVector lineSearchResidual_;
+    GlobalEqVector lineSearchUpdate_;
+    // true while the line search applies a step length
+    bool applyingLineSearchStep_;
+
+    // the history of Anderson acceleration
+    std::vector<GlobalEqVector> andersonDeltaF_;
+    std::vector<GlobalEqVector> andersonDeltaG_;
+    GlobalEqVector andersonLastF_;
+    GlobalEqVector andersonLastG_;
+    unsigned andersonHistorySize_;
+    unsigned andersonNextSlot_;
+    bool andersonHasLast_;
+
 private:
+    // returns whether the tolerance of the linear solver backend can be changed
+    static constexpr bool linearSolverHasSetTolerance_()
+    { return detail::LinearSolverHasSetTolerance<LinearSolverBackend, Scalar>::value; }
+
+    void setLinearSolverTolerance_(Scalar value, std::true_type)
+    { linearSolver_.setTolerance(value); }
+
+    // the constructor makes sure that this is not called if the tolerance is supposed
+    // to be adapted
+    void setLinearSolverTolerance_(Scalar value OPM_UNUSED, std::false_type)
+    { }
+
+    // returns whether the linear solver backend can reuse its preconditioner
+    static constexpr bool linearSolverHasPrepareUnchangedMatrix_()
+    { return detail::LinearSolverHasPrepareUnchangedMatrix<LinearSolverBackend>::value; }
+
+    void prepareUnchangedMatrix_(const JacobianMatrix& M OPM_UNUSED, std::true_type)
+    { linearSolver_.prepareUnchangedMatrix(); }
+
+    // if the backend cannot reuse its preconditioner, the frozen Jacobian matrix is
+    // prepared from scratch. this still saves its linearization.
+    void prepareUnchangedMatrix_(const JacobianMatrix& M, std::false_type)
+    { linearSolver_.prepareMatrix(M); }
+
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
     const Implementation& asImp_() const
@@ -0,0 +1,55 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::parallelZero
+ */
+#ifndef EWOMS_PARALLEL_ZERO_HH
+#define EWOMS_PARALLEL_ZERO_HH
+
+namespace Ewoms {
+
+/*!
+ * \brief Set all rows of a Dune::BCRSMatrix or all blocks of a Dune::BlockVector to zero
+ *        using all OpenMP threads.
+ *
+ * The rows are statically distributed to the threads in contiguous ranges of equal
+ * size. Note that this only distributes the work: since the containers are
+ * initialized by the thread which allocates them, this function does not influence
+ * the NUMA node on which their memory resides.
+ */
+template <class RowContainer>
+void parallelZero(RowContainer& container)
+{
+    int numRows = static_cast<int>(container.N());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        container[static_cast<unsigned>(rowIdx)] = 0.0;
+}
+
+} // namespace Ewoms
+
+#endif
@@ -0,0 +1,255 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::ThreadedEntityScheduler
+ */
+#ifndef EWOMS_THREADED_ENTITY_SCHEDULER_HH
+#define EWOMS_THREADED_ENTITY_SCHEDULER_HH
+
+#include <ewoms/parallel/locks.hh>
+
+#include <dune/common/version.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace Ewoms {
+
+/*!
+ * \brief Distributes the entities of a GridView to the threads of an OpenMP parallel
+ *        region in chunks.
+ *
+ * When the object is created, the grid view is flattened into a list of entity seeds.
+ * The chunks of this list are initially distributed evenly to the threads. Each thread
+ * processes its own chunks front to back. If a thread has no work left, it steals half
+ * of the remaining chunks of another thread from the back. This means that a lock is
+ * only acquired once per chunk instead of once per entity (like for
+ * ThreadedEntityIterator), and a thread which gets expensive entities does not stall
+ * the others.
+ *
+ * Usage:
+ * \code
+ * ThreadedEntityScheduler<GridView, 0> elemScheduler(gridView);
+ * #pragma omp parallel
+ * {
+ *     ElementContext elemCtx(simulator);
+ *     elemScheduler.run([&](const Element& elem) {
+ *         elemCtx.updateAll(elem);
+ *         ...
+ *     });
+ * }
+ * \endcode
+ *
+ * ATTENTION: The constructor, update() and rewind() must be called in a sequential
+ * context!
+ */
+template <class GridView, int codim>
+class ThreadedEntityScheduler
+{
+    typedef typename GridView::Grid Grid;
+    typedef typename GridView::template Codim<codim>::Entity Entity;
+    typedef typename GridView::template Codim<codim>::Iterator EntityIterator;
+    typedef typename Entity::EntitySeed EntitySeed;
+
+    // the chunks which are still to be processed by a thread. the padding avoids that
+    // the queues of different threads share a cache line.
+    struct ChunkQueue
+    {
+        OmpMutex mutex;
+        size_t beginChunk;
+        size_t endChunk;
+        char padding[64];
+    };
+
+public:
+    /*!
+     * \brief The default number of entities which are handed out at once.
+     */
+    static const size_t defaultChunkSize = 64;
+
+    explicit ThreadedEntityScheduler(const GridView& gridView,
+                                     size_t chunkSize = defaultChunkSize)
+        : gridView_(gridView)
+        , chunkSize_(std::max<size_t>(chunkSize, 1))
+    { update(); }
+
+    /*!
+     * \brief Flatten the grid view into a list of entity seeds.
+     *
+     * This needs to be called if the grid was changed since the object was created.
+     */
+    void update()
+    {
+        seeds_.clear();
+        seeds_.reserve(static_cast<size_t>(gridView_.size(codim)));
+
+        EntityIterator it = gridView_.template begin<codim>();
+        const EntityIterator& endIt = gridView_.template end<codim>();
+        for (; it != endIt; ++it)
+            seeds_.push_back(it->seed());
+
+        rewind();
+    }
+
+    /*!
+     * \brief Prepare the object for another sweep over the entities.
+     */
+    void rewind()
+    {
+#ifdef _OPENMP
+        size_t numThreads = static_cast<size_t>(omp_get_max_threads());
+#else
+        size_t numThreads = 1;
+#endif
+        size_t numChunks = (seeds_.size() + chunkSize_ - 1)/chunkSize_;
+
+        // assign contiguous ranges of chunks to the threads so that each thread works
+        // on nearby entities as long as no work is stolen
+        queues_.resize(numThreads);
+        for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            queues_[threadIdx].beginChunk = (threadIdx*numChunks)/numThreads;
+            queues_[threadIdx].endChunk = ((threadIdx + 1)*numChunks)/numThreads;
+        }
+    }
+
+    /*!
+     * \brief Returns the number of entities of the grid view.
+     */
+    size_t numEntities() const
+    { return seeds_.size(); }
+
+    /*!
+     * \brief Returns the seed of the entity with a given index.
+     */
+    const EntitySeed& seed(size_t entityIdx) const
+    { return seeds_[entityIdx]; }
+
+    /*!
+     * \brief Get the next range of entity indices to be processed by the current thread.
+     *
+     * The range is [begin, end). If false is returned, there are no entities left.
+     */
+    bool nextRange(size_t& begin, size_t& end)
+    {
+        size_t chunkIdx;
+        if (!nextChunk_(chunkIdx))
+            return false;
+
+        begin = chunkIdx*chunkSize_;
+        end = std::min(begin + chunkSize_, seeds_.size());
+        return true;
+    }
+
+    /*!
+     * \brief Call a functor for each entity which is handed out to the current thread.
+     *
+     * This method must be called by each thread of an OpenMP parallel region.
+     */
+    template <class Functor>
+    void run(const Functor& functor)
+    {
+        const Grid& grid = gridView_.grid();
+
+        size_t begin, end;
+        while (nextRange(begin, end)) {
+            for (size_t entityIdx = begin; entityIdx < end; ++entityIdx) {
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 4)
+                const Entity entity = grid.entity(seeds_[entityIdx]);
+#else
+                const auto entityPtr = grid.entityPointer(seeds_[entityIdx]);
+                const Entity& entity = *entityPtr;
+#endif
+                functor(entity);
+            }
+        }
+    }
+
+private:
+    bool nextChunk_(size_t& chunkIdx)
+    {
+#ifdef _OPENMP
+        size_t threadIdx = static_cast<size_t>(omp_get_thread_num());
+#else
+        size_t threadIdx = 0;
+#endif
+        assert(threadIdx < queues_.size());
+        ChunkQueue& ownQueue = queues_[threadIdx];
+
+        while (true) {
+            // take the front chunk of the thread's own queue
+            ownQueue.mutex.lock();
+            if (ownQueue.beginChunk < ownQueue.endChunk) {
+                chunkIdx = ownQueue.beginChunk++;
+                ownQueue.mutex.unlock();
+                return true;
+            }
+            ownQueue.mutex.unlock();
+
+            // the own queue is empty: steal half of the chunks of another thread
+            size_t stolenBegin, stolenEnd;
+            if (!steal_(threadIdx, stolenBegin, stolenEnd))
+                return false;
+
+            ownQueue.mutex.lock();
+            ownQueue.beginChunk = stolenBegin;
+            ownQueue.endChunk = stolenEnd;
+            ownQueue.mutex.unlock();
+        }
+    }
+
+    bool steal_(size_t thiefIdx, size_t& stolenBegin, size_t& stolenEnd)
+    {
+        size_t numThreads = queues_.size();
+        for (size_t i = 1; i < numThreads; ++i) {
+            ChunkQueue& victimQueue = queues_[(thiefIdx + i) % numThreads];
+
+            victimQueue.mutex.lock();
+            if (victimQueue.beginChunk < victimQueue.endChunk) {
+                size_t numRemaining = victimQueue.endChunk - victimQueue.beginChunk;
+                size_t numStolen = (numRemaining + 1)/2;
+                stolenEnd = victimQueue.endChunk;
+                stolenBegin = stolenEnd - numStolen;
+                victimQueue.endChunk = stolenBegin;
+                victimQueue.mutex.unlock();
+                return true;
+            }
+            victimQueue.mutex.unlock();
+        }
+
+        return false;
+    }
+
+    GridView gridView_;
+    size_t chunkSize_;
+    std::vector<EntitySeed> seeds_;
+    std::vector<ChunkQueue> queues_;
+};
+} // namespace Ewoms
+
+#endif
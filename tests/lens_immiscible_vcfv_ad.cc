@@ -28,22 +28,9 @@
  */
 #include "config.h"
 
-#include <ewoms/common/start.hh>
-#include <ewoms/models/immiscible/immisciblemodel.hh>
-#include "problems/lensproblem.hh"
-
-namespace Ewoms {
-namespace Properties {
-NEW_TYPE_TAG(LensProblemVcfvAd, INHERITS_FROM(ImmiscibleTwoPhaseModel, LensBaseProblem));
+#include "lens_immiscible_vcfv_ad.hh"
 
-// use automatic differentiation for this simulator
-SET_TAG_PROP(LensProblemVcfvAd, LocalLinearizerSplice, AutoDiffLocalLinearizer);
-
-// use linear finite element gradients if dune-localfunctions is available
-#if HAVE_DUNE_LOCALFUNCTIONS
-SET_BOOL_PROP(LensProblemVcfvAd, UseP1FiniteElementGradients, true);
-#endif
-}}
+#include <ewoms/common/start.hh>
 
 int main(int argc, char **argv)
 {
@@ -0,0 +1,131 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Infrastructure to test that linearizing the global system of equations does
+ *        not allocate any memory once all buffers have been sized.
+ *
+ * The global operator new and posix_memalign() (which is used by
+ * Ewoms::aligned_allocator) are replaced by versions which count the number of
+ * allocations. This file must thus only be included by a single compile unit of a
+ * program.
+ */
+#ifndef EWOMS_LINEARIZATION_ALLOCATIONS_HH
+#define EWOMS_LINEARIZATION_ALLOCATIONS_HH
+
+#include <ewoms/common/start.hh>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+std::atomic<bool> countAllocations(false);
+std::atomic<size_t> numAllocations(0);
+
+void recordAllocation_()
+{
+    if (countAllocations)
+        ++numAllocations;
+}
+} // anonymous namespace
+
+void* operator new(size_t size)
+{
+    recordAllocation_();
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{ return operator new(size); }
+
+void operator delete(void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept
+{ std::free(ptr); }
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+{
+    recordAllocation_();
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr ? 0 : ENOMEM;
+}
+#endif
+
+/*!
+ * \brief Linearize the problem specified by a type tag twice and check that the second
+ *        linearization does not allocate any memory.
+ */
+template <class TypeTag>
+int checkLinearizationAllocations(int argc, char **argv)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
+
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    int paramStatus = Ewoms::setupParameters_<TypeTag>(argc, argv);
+    if (paramStatus == 1)
+        return 1;
+    if (paramStatus == 2)
+        return 0;
+
+    ThreadManager::init();
+
+    Simulator simulator;
+    simulator.model().applyInitialSolution();
+
+    // the first linearization allocates the global system of equations and sizes the
+    // buffers of the element contexts and of the local linearizers
+    auto& linearizer = simulator.model().linearizer();
+    linearizer.linearize();
+
+    countAllocations = true;
+    linearizer.linearize();
+    countAllocations = false;
+
+    if (numAllocations > 0) {
+        std::cerr << "Linearizing the system of equations allocated memory "
+                  << numAllocations << " times\n";
+        return 1;
+    }
+
+    std::cout << "Linearizing the system of equations did not allocate any memory\n";
+    return 0;
+}
+
+#endif // EWOMS_LINEARIZATION_ALLOCATIONS_HH
@@ -163,6 +163,9 @@ SET_SCALAR_PROP(Co2InjectionBaseProblem, InitialTimeStepSize, 250);
 
 // The default DGF file to load
 SET_STRING_PROP(Co2InjectionBaseProblem, GridFile, "data/co2injection.dgf");
+
+// enable the storage cache by default for this problem
+SET_BOOL_PROP(Co2InjectionBaseProblem, EnableStorageCache, true);
 } // namespace Properties
 } // namespace Ewoms
 
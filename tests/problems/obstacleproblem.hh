@@ -111,6 +111,9 @@ SET_SCALAR_PROP(ObstacleBaseProblem, InitialTimeStepSize, 250);
 
 // The default DGF file to load
 SET_STRING_PROP(ObstacleBaseProblem, GridFile, "./data/obstacle_24x16.dgf");
+
+// enable the storage cache by default for this problem
+SET_BOOL_PROP(ObstacleBaseProblem, EnableStorageCache, true);
 } // namespace Properties
 } // namespace Ewoms
 